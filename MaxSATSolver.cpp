@@ -6,19 +6,37 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstring>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <condition_variable>
+#include <deque>
 #include <vector>
 #include <cmath>
 #include <numeric>
 #include <iomanip>
+#include <map>
 #include <random> // Para generacion aleatoria segura en hilos
 #include <omp.h>  // Para poder usar tu CPU al maximo
 #include <mutex>  // Para que el texto no se mezcle en consola
 #include <cmath>   // para sqrt, pow
+#include <fcntl.h>    // Carga de archivos con mmap
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h> // Pico de memoria (getrusage)
+#include <sys/file.h>     // flock: nodos que guardan la misma solución
+#include <dirent.h>     // Directorios de instancias en la línea de comandos
+#include <unistd.h>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h> // Kernels vectoriales de evaluación (con -mavx2 / -march=native)
+#endif
 
 using namespace std;
 
@@ -32,10 +50,13 @@ enum class TBool : int8_t
   True = 1
 };
 
+// Pesos y costos de MaxSAT ponderado
+using Peso = int64_t;
+
 struct Conteo
 {
-  int pos = 0;
-  int neg = 0;
+  Peso pos = 0;
+  Peso neg = 0;
   void reset()
   {
     pos = 0;
@@ -43,497 +64,5056 @@ struct Conteo
   }
 };
 
-class Clausula
+// Codificación de literales: lit = 2 * indiceVariable + negado
+inline int varDeLiteral(int lit) { return lit >> 1; }
+inline bool esNegado(int lit) { return lit & 1; }
+inline int codificarLiteral(int dimacs) { return ((abs(dimacs) - 1) << 1) | (dimacs < 0); }
+
+// Verdadero solo si la variable está asignada y coincide con el signo del literal
+inline bool literalVerdadero(int lit, TBool valor) { return ((int)valor ^ (lit & 1)) == 1; }
+
+// Paso de splitmix64: mezcla un contador de 64 bits; siembra y deriva semillas
+inline uint64_t splitmix64(uint64_t &estado)
+{
+  uint64_t z = (estado += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+// Semilla hija de (base, clave): corridas y métodos obtienen flujos independientes
+// que no dependen del orden en que los hilos ejecuten las tareas
+inline uint64_t derivarSemilla(uint64_t base, uint64_t clave)
+{
+  uint64_t estado = base ^ splitmix64(clave);
+  return splitmix64(estado);
+}
+
+/**
+ * Generador xoshiro256**: 32 bytes de estado frente a los 5 KB de mt19937, y
+ * unas pocas operaciones por número. Cumple UniformRandomBitGenerator, así que
+ * sirve con las distribuciones de <random>. El estado se siembra con splitmix64
+ * para que semillas cercanas (corridas consecutivas) den secuencias no correlacionadas.
+ */
+class Xoshiro256
 {
 private:
-  vector<int> variables;
-  TBool satisfaccion;
+  uint64_t s[4];
+
+  static uint64_t rotar(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
 
 public:
-  Clausula() { satisfaccion = TBool::Unknown; }
-  Clausula(vector<int> vars)
+  using result_type = uint64_t;
+
+  explicit Xoshiro256(uint64_t semilla)
   {
-    variables = vars;
-    satisfaccion = TBool::Unknown;
+    for (uint64_t &palabra : s)
+      palabra = splitmix64(semilla);
   }
 
-  const vector<int> &getVariables() const { return variables; }
-  TBool getSatisfaccion() const { return satisfaccion; }
-  void reset() { satisfaccion = TBool::Unknown; }
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return numeric_limits<result_type>::max(); }
 
-  void setSatisfaccion(const vector<TBool> &variablesGlobales, vector<Conteo> *ptrFrecuencias)
+  result_type operator()()
   {
-    bool esperanza = false;
-    for (const int &v : variables)
-    {
-      int indice = abs(v) - 1;
-      TBool valorVar = variablesGlobales[indice];
+    uint64_t resultado = rotar(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotar(s[3], 45);
+    return resultado;
+  }
+};
+
+using Generador = Xoshiro256;
+
+/**
+ * Asignación empaquetada en bits: valores guarda el valor de cada variable y
+ * asignadas cuáles tienen valor (la fase constructiva deja variables sin
+ * asignar). Copiarla mueve n/4 bytes en lugar de n, por eso las instantáneas
+ * de la mejor solución de las metaheurísticas usan este tipo.
+ */
+class AsignacionCompacta
+{
+private:
+  int n = 0;
+  vector<uint64_t> valores;
+  vector<uint64_t> asignadas;
+
+public:
+  AsignacionCompacta() {}
+  explicit AsignacionCompacta(int nVars) : n(nVars), valores((nVars + 63) / 64, 0), asignadas((nVars + 63) / 64, 0) {}
+  explicit AsignacionCompacta(const vector<TBool> &vars) { empaquetar(vars); }
 
-      if ((v > 0 && valorVar == TBool::True) || (v < 0 && valorVar == TBool::False))
+  void empaquetar(const vector<TBool> &vars)
+  {
+    n = vars.size();
+    valores.assign((n + 63) / 64, 0);
+    asignadas.assign((n + 63) / 64, 0);
+    for (int v = 0; v < n; v++)
+      if (vars[v] != TBool::Unknown)
       {
-        satisfaccion = TBool::True;
-        actualizarFrecuencias(ptrFrecuencias);
-        return;
+        asignadas[v >> 6] |= 1ULL << (v & 63);
+        if (vars[v] == TBool::True)
+          valores[v >> 6] |= 1ULL << (v & 63);
       }
-      if (valorVar == TBool::Unknown)
-        esperanza = true;
+  }
+
+  void desempaquetar(vector<TBool> &vars) const
+  {
+    vars.resize(n);
+    for (int v = 0; v < n; v++)
+      vars[v] = get(v);
+  }
+
+  TBool get(int v) const
+  {
+    uint64_t bit = 1ULL << (v & 63);
+    if (!(asignadas[v >> 6] & bit))
+      return TBool::Unknown;
+    return (valores[v >> 6] & bit) ? TBool::True : TBool::False;
+  }
+
+  void flip(int v) { valores[v >> 6] ^= 1ULL << (v & 63); }
+
+  void asignar(int v, bool valor)
+  {
+    uint64_t bit = 1ULL << (v & 63);
+    asignadas[v >> 6] |= bit;
+    valores[v >> 6] = valor ? (valores[v >> 6] | bit) : (valores[v >> 6] & ~bit);
+  }
+
+  int numVariables() const { return n; }
+  int numPalabras() const { return valores.size(); }
+  uint64_t palabraValores(int i) const { return valores[i]; }
+  uint64_t palabraAsignadas(int i) const { return asignadas[i]; }
+};
+
+/**
+ * Representación compacta e inmutable de una fórmula en CNF o WCNF. Todos los
+ * literales (ya codificados y sin repetidos dentro de cada cláusula) viven en
+ * un único arreglo contiguo; la cláusula c ocupa [inicio[c], inicio[c + 1]).
+ * Incluye el índice variable -> cláusulas en el mismo formato. Se construye una
+ * vez por archivo y se comparte de solo lectura entre corridas e hilos.
+ *
+ * Cada cláusula tiene un peso. Las duras reciben en finalizar() un peso igual a
+ * la suma de los pesos blandos + 1, de modo que violar una sola dura siempre
+ * cuesta más que violar todas las blandas. Una CNF sin pesos es el caso con
+ * todas las cláusulas blandas de peso 1 (costo = cláusulas insatisfechas).
+ */
+class FormulaCompacta
+{
+private:
+  int numVariables = 0;
+  vector<int> literales;
+  vector<int> inicio{0};
+  vector<int> ocurrencias; // 2 * clausula + negado
+  vector<int> inicioOcurrencias;
+  vector<char> tautologica;
+  vector<Peso> pesos;
+  vector<char> dura;
+  Peso pesoDuro = 1;
+  int ancho = -1; // longitud común de todas las cláusulas, -1 si varían
+
+  // Frecuencias de la heurística: blandas ponderadas y duras contadas aparte
+  vector<Conteo> frecBlandas, frecDuras, frecuencias;
+
+  void calcularAncho()
+  {
+    ancho = numClausulas() > 0 ? longitud(0) : -1;
+    for (int c = 1; c < numClausulas() && ancho != -1; c++)
+      if (longitud(c) != ancho)
+        ancho = -1;
+  }
+
+  void asegurarVariable(int v)
+  {
+    if (v <= numVariables)
+      return;
+    numVariables = v;
+    frecBlandas.resize(v);
+    frecDuras.resize(v);
+  }
+
+public:
+  FormulaCompacta() {}
+  explicit FormulaCompacta(int nVars) : numVariables(nVars), frecBlandas(nVars), frecDuras(nVars) {}
+
+  void reservar(int nClausulas, size_t nLiterales)
+  {
+    inicio.reserve(nClausulas + 1);
+    tautologica.reserve(nClausulas);
+    pesos.reserve(nClausulas);
+    dura.reserve(nClausulas);
+    literales.reserve(nLiterales);
+  }
+
+  /**
+   * Agrega una cláusula en formato DIMACS (sin el 0 final). Elimina literales
+   * repetidos, marca tautologías y acumula las apariciones de cada literal.
+   */
+  void agregarClausula(vector<int> &dimacs, Peso peso = 1, bool esDura = false)
+  {
+    sort(dimacs.begin(), dimacs.end());
+    dimacs.erase(unique(dimacs.begin(), dimacs.end()), dimacs.end());
+    bool esTautologia = false;
+    for (int v : dimacs)
+      if (v > 0 && binary_search(dimacs.begin(), dimacs.end(), -v))
+        esTautologia = true;
+
+    // Las tautologías siempre se satisfacen: no aportan a las frecuencias
+    for (int v : dimacs)
+    {
+      asegurarVariable(abs(v));
+      literales.push_back(codificarLiteral(v));
+      if (esTautologia)
+        continue;
+      Conteo &f = esDura ? frecDuras[abs(v) - 1] : frecBlandas[abs(v) - 1];
+      if (v > 0)
+        f.pos += esDura ? 1 : peso;
+      else
+        f.neg += esDura ? 1 : peso;
     }
+    inicio.push_back(literales.size());
+    tautologica.push_back(esTautologia);
+    pesos.push_back(esDura ? 0 : peso);
+    dura.push_back(esDura);
+  }
 
-    if (!esperanza)
+  /**
+   * Fija el peso de las duras, combina las frecuencias y construye el índice de
+   * ocurrencias (conteo + prefijos). Las tautologías se excluyen del índice.
+   */
+  void finalizar()
+  {
+    pesoDuro = 1;
+    for (int c = 0; c < numClausulas(); c++)
+      if (!dura[c] && !tautologica[c])
+        pesoDuro += pesos[c];
+    for (int c = 0; c < numClausulas(); c++)
+      if (dura[c])
+        pesos[c] = pesoDuro;
+
+    frecuencias.assign(numVariables, Conteo());
+    for (int v = 0; v < numVariables; v++)
     {
-      satisfaccion = TBool::False;
-      actualizarFrecuencias(ptrFrecuencias);
+      frecuencias[v].pos = frecBlandas[v].pos + frecDuras[v].pos * pesoDuro;
+      frecuencias[v].neg = frecBlandas[v].neg + frecDuras[v].neg * pesoDuro;
     }
-    else
+    vector<Conteo>().swap(frecBlandas);
+    vector<Conteo>().swap(frecDuras);
+    // La reserva del parser es una estimación por tamaño de archivo: se
+    // devuelve el sobrante antes de crear el índice, que ocupa lo mismo
+    if (literales.capacity() > literales.size() + literales.size() / 8)
+      literales.shrink_to_fit();
+
+    inicioOcurrencias.assign(numVariables + 1, 0);
+    for (int c = 0; c < numClausulas(); c++)
+      if (!tautologica[c])
+        for (int k = inicio[c]; k < inicio[c + 1]; k++)
+          inicioOcurrencias[varDeLiteral(literales[k]) + 1]++;
+    for (int v = 0; v < numVariables; v++)
+      inicioOcurrencias[v + 1] += inicioOcurrencias[v];
+
+    ocurrencias.resize(inicioOcurrencias[numVariables]);
+    vector<int> cursor(inicioOcurrencias.begin(), inicioOcurrencias.end() - 1);
+    for (int c = 0; c < numClausulas(); c++)
+      if (!tautologica[c])
+        for (int k = inicio[c]; k < inicio[c + 1]; k++)
+          ocurrencias[cursor[varDeLiteral(literales[k])]++] = (c << 1) | esNegado(literales[k]);
+    calcularAncho();
+  }
+
+  int getNumVariables() const { return numVariables; }
+  int numClausulas() const { return (int)inicio.size() - 1; }
+  size_t numLiterales() const { return literales.size(); }
+  int longitud(int c) const { return inicio[c + 1] - inicio[c]; }
+  const int *literalesDe(int c) const { return literales.data() + inicio[c]; }
+  const int *finDe(int c) const { return literales.data() + inicio[c + 1]; }
+
+  /**
+   * Variantes de ancho fijo: si todas las cláusulas tienen K literales (K > 0)
+   * el arreglo de literales es un arreglo de registros de K enteros y la
+   * cláusula c empieza en K * c, sin leer inicio. K = 0 es el camino genérico.
+   */
+  template <int K>
+  const int *literalesDe(int c) const { return K > 0 ? literales.data() + K * c : literalesDe(c); }
+  template <int K>
+  const int *finDe(int c) const { return K > 0 ? literales.data() + K * (c + 1) : finDe(c); }
+  bool esTautologica(int c) const { return tautologica[c]; }
+  Peso peso(int c) const { return pesos[c]; }
+  bool esDura(int c) const { return dura[c]; }
+  Peso getPesoDuro() const { return pesoDuro; }
+  const vector<Conteo> &getFrecuencias() const { return frecuencias; }
+  int anchoUniforme() const { return ancho; }
+  const int *getLiterales() const { return literales.data(); }
+  const Peso *getPesos() const { return pesos.data(); }
+
+  // Bytes reservados por el arreglo de literales y por toda la fórmula
+  size_t bytesLiterales() const { return literales.capacity() * sizeof(int); }
+  size_t bytesMemoria() const
+  {
+    return bytesLiterales() + (inicio.capacity() + ocurrencias.capacity() + inicioOcurrencias.capacity()) * sizeof(int) +
+           tautologica.capacity() + dura.capacity() + pesos.capacity() * sizeof(Peso) +
+           (frecBlandas.capacity() + frecDuras.capacity() + frecuencias.capacity()) * sizeof(Conteo);
+  }
+
+  /**
+   * Formato binario .cnfbin: una cabecera fija seguida de los arreglos planos,
+   * cada uno alineado a 8 bytes. La cabecera guarda el tamaño y el hash del
+   * texto fuente para invalidar el caché cuando el .cnf cambia.
+   */
+  struct CabeceraBinaria
+  {
+    char magia[8];
+    uint64_t hashFuente;
+    uint64_t tamFuente;
+    int64_t numVariables;
+    int64_t numClausulas;
+    int64_t numLiterales;
+    int64_t numOcurrencias;
+    Peso pesoDuro;
+  };
+
+  bool escribirBinario(const string &nombre, uint64_t hashFuente, uint64_t tamFuente) const
+  {
+    CabeceraBinaria cab = {{'C', 'N', 'F', 'B', 'I', 'N', '0', '1'}, hashFuente, tamFuente, numVariables,
+                           numClausulas(), (int64_t)literales.size(), (int64_t)ocurrencias.size(), pesoDuro};
+    // Se escribe a un temporal y se renombra para no dejar cachés a medias
+    string temporal = nombre + ".tmp" + to_string(getpid());
+    ofstream out(temporal, ios::binary);
+    if (!out)
+      return false;
+
+    auto escribir = [&out](const void *datos, size_t bytes)
     {
-      satisfaccion = TBool::Unknown;
+      static const char relleno[8] = {};
+      out.write((const char *)datos, bytes);
+      out.write(relleno, (8 - bytes % 8) % 8);
+    };
+    escribir(&cab, sizeof(cab));
+    escribir(literales.data(), literales.size() * sizeof(int));
+    escribir(inicio.data(), inicio.size() * sizeof(int));
+    escribir(ocurrencias.data(), ocurrencias.size() * sizeof(int));
+    escribir(inicioOcurrencias.data(), inicioOcurrencias.size() * sizeof(int));
+    escribir(tautologica.data(), tautologica.size());
+    escribir(pesos.data(), pesos.size() * sizeof(Peso));
+    escribir(dura.data(), dura.size());
+    escribir(frecuencias.data(), frecuencias.size() * sizeof(Conteo));
+    out.close();
+
+    if (!out || rename(temporal.c_str(), nombre.c_str()) != 0)
+    {
+      remove(temporal.c_str());
+      return false;
     }
+    return true;
   }
 
-  bool esSatisfecha(const vector<TBool> &variablesGlobales) const
+  // Reconstruye la fórmula desde un .cnfbin en memoria; false si no corresponde a la fuente
+  bool leerBinario(const char *datos, size_t tamano, uint64_t hashFuente, uint64_t tamFuente)
   {
-    for (int v : variables)
+    CabeceraBinaria cab;
+    if (tamano < sizeof(cab))
+      return false;
+    memcpy(&cab, datos, sizeof(cab));
+    if (memcmp(cab.magia, "CNFBIN01", 8) != 0 || cab.hashFuente != hashFuente || cab.tamFuente != tamFuente)
+      return false;
+
+    size_t pos = 0;
+    bool valido = true;
+    auto leer = [&](auto &destino, size_t cantidad)
     {
-      int idx = abs(v) - 1;
-      if (variablesGlobales[idx] == TBool::Unknown)
-        continue;
-      if ((v > 0 && variablesGlobales[idx] == TBool::True) ||
-          (v < 0 && variablesGlobales[idx] == TBool::False))
+      using T = typename decay_t<decltype(destino)>::value_type;
+      pos = (pos + 7) / 8 * 8;
+      size_t bytes = cantidad * sizeof(T);
+      if (!valido || pos + bytes > tamano)
       {
-        return true;
+        valido = false;
+        return;
       }
-    }
-    return false;
+      destino.resize(cantidad);
+      memcpy(destino.data(), datos + pos, bytes);
+      pos += bytes;
+    };
+    pos = sizeof(cab);
+    leer(literales, cab.numLiterales);
+    leer(inicio, cab.numClausulas + 1);
+    leer(ocurrencias, cab.numOcurrencias);
+    leer(inicioOcurrencias, cab.numVariables + 1);
+    leer(tautologica, cab.numClausulas);
+    leer(pesos, cab.numClausulas);
+    leer(dura, cab.numClausulas);
+    leer(frecuencias, cab.numVariables);
+    if (!valido)
+      return false;
+
+    numVariables = cab.numVariables;
+    pesoDuro = cab.pesoDuro;
+    calcularAncho();
+    return true;
   }
 
-  bool aparece(int variable)
+  const int *ocurrenciasDe(int v) const { return ocurrencias.data() + inicioOcurrencias[v]; }
+  const int *finOcurrenciasDe(int v) const { return ocurrencias.data() + inicioOcurrencias[v + 1]; }
+
+  bool esSatisfecha(int c, const vector<TBool> &vars) const
   {
-    for (int v : variables)
-      if (abs(v) == variable + 1)
+    for (const int *l = literalesDe(c), *fin = finDe(c); l != fin; l++)
+      if (literalVerdadero(*l, vars[varDeLiteral(*l)]))
         return true;
     return false;
   }
+};
 
-  void actualizarFrecuencias(vector<Conteo> *ptrFrecuencias)
+/**
+ * Llama a f con el ancho uniforme de la fórmula como constante de compilación
+ * (integral_constant<int, K>) para los k-SAT habituales; cualquier otro ancho,
+ * o una fórmula de anchos mixtos, usa K = 0 (camino genérico).
+ */
+template <class F>
+inline void despacharAncho(int ancho, F f)
+{
+  switch (ancho)
   {
-    if (!ptrFrecuencias)
-      return;
-    for (int &variable : variables)
+  case 2:
+    f(integral_constant<int, 2>());
+    break;
+  case 3:
+    f(integral_constant<int, 3>());
+    break;
+  case 4:
+    f(integral_constant<int, 4>());
+    break;
+  default:
+    f(integral_constant<int, 0>());
+  }
+}
+
+/**
+ * Tabla de verdad de los literales para evaluar una asignación empaquetada: el
+ * bit lit está encendido si el literal lit (= 2 * variable + negado) es
+ * verdadero, así cada literal se evalúa con una sola lectura.
+ */
+struct TablaLiterales
+{
+  vector<uint64_t> palabras;
+
+  // Intercala los 32 bits de x en las posiciones pares de 64 bits
+  static uint64_t esparcir(uint64_t x)
+  {
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    x = (x | (x << 2)) & 0x3333333333333333ULL;
+    x = (x | (x << 1)) & 0x5555555555555555ULL;
+    return x;
+  }
+
+  explicit TablaLiterales(const AsignacionCompacta &a) : palabras(2 * a.numPalabras())
+  {
+    for (int i = 0; i < a.numPalabras(); i++)
     {
-      if (variable > 0)
-        (*ptrFrecuencias)[abs(variable) - 1].pos--;
-      else
-        (*ptrFrecuencias)[abs(variable) - 1].neg--;
+      uint64_t pos = a.palabraValores(i) & a.palabraAsignadas(i);
+      uint64_t neg = ~a.palabraValores(i) & a.palabraAsignadas(i);
+      palabras[2 * i] = esparcir(pos & 0xFFFFFFFFULL) | (esparcir(neg & 0xFFFFFFFFULL) << 1);
+      palabras[2 * i + 1] = esparcir(pos >> 32) | (esparcir(neg >> 32) << 1);
     }
   }
+
+  bool verdadero(int lit) const { return (palabras[lit >> 6] >> (lit & 63)) & 1; }
+  const int *datos32() const { return (const int *)palabras.data(); }
 };
 
-class Formula
+#if defined(__AVX512F__)
+// Máscara de las cláusulas c..c+15 (de exactamente 3 literales) que quedan falsificadas
+inline unsigned falsificadasAncho3(const int *literales, int c, const TablaLiterales &tabla)
+{
+  const __m512i indices = _mm512_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 30, 33, 36, 39, 42, 45);
+  const __m512i uno = _mm512_set1_epi32(1);
+  const __m512i treintaYUno = _mm512_set1_epi32(31);
+  const __m512i cero = _mm512_setzero_si512();
+  __m512i satisfecha = cero;
+  for (int j = 0; j < 3; j++)
+  {
+    __m512i lit = _mm512_mask_i32gather_epi32(cero, 0xFFFF, indices, literales + 3 * c + j, 4);
+    __m512i bits = _mm512_mask_i32gather_epi32(cero, 0xFFFF, _mm512_maskz_srli_epi32(0xFFFF, lit, 5), tabla.datos32(), 4);
+    satisfecha = _mm512_or_si512(satisfecha, _mm512_maskz_srlv_epi32(0xFFFF, bits, _mm512_and_si512(lit, treintaYUno)));
+  }
+  return _mm512_testn_epi32_mask(satisfecha, uno);
+}
+const int BLOQUE_ANCHO3 = 16;
+#elif defined(__AVX2__)
+// Máscara de las cláusulas c..c+7 (de exactamente 3 literales) que quedan falsificadas
+inline unsigned falsificadasAncho3(const int *literales, int c, const TablaLiterales &tabla)
+{
+  const __m256i indices = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+  const __m256i uno = _mm256_set1_epi32(1);
+  const __m256i treintaYUno = _mm256_set1_epi32(31);
+  __m256i satisfecha = _mm256_setzero_si256();
+  for (int j = 0; j < 3; j++)
+  {
+    __m256i lit = _mm256_i32gather_epi32(literales + 3 * c + j, indices, 4);
+    __m256i bits = _mm256_i32gather_epi32(tabla.datos32(), _mm256_srli_epi32(lit, 5), 4);
+    satisfecha = _mm256_or_si256(satisfecha, _mm256_srlv_epi32(bits, _mm256_and_si256(lit, treintaYUno)));
+  }
+  __m256i falsa = _mm256_cmpeq_epi32(_mm256_and_si256(satisfecha, uno), _mm256_setzero_si256());
+  return _mm256_movemask_ps(_mm256_castsi256_ps(falsa));
+}
+const int BLOQUE_ANCHO3 = 8;
+#endif
+
+/**
+ * Contadores de trabajo de la búsqueda. Los lleva cada evaluador (un entero
+ * por evento, sin atómicos) y se restan/suman para atribuirlos a cada método.
+ */
+struct Contadores
+{
+  long long flips = 0;
+  long long evaluados = 0; // consultas de delta o break de un movimiento
+  long long recuentos = 0; // evaluaciones completas de una asignación
+  long long copias = 0;    // instantáneas de la mejor solución
+
+  Contadores &operator+=(const Contadores &o)
+  {
+    flips += o.flips;
+    evaluados += o.evaluados;
+    recuentos += o.recuentos;
+    copias += o.copias;
+    return *this;
+  }
+
+  Contadores operator-(const Contadores &o) const
+  {
+    Contadores r = *this;
+    r.flips -= o.flips;
+    r.evaluados -= o.evaluados;
+    r.recuentos -= o.recuentos;
+    r.copias -= o.copias;
+    return r;
+  }
+};
+
+/**
+ * Mejor solución de una trayectoria guardada como los flips hechos desde que se
+ * alcanzó, en lugar de una copia: marcarMejor() vacía esa cola en O(1), y volver
+ * al mejor o materializarlo cuesta lo proporcional a los flips posteriores, no a
+ * n. Si la cola pasa de 2n flips se compacta a las variables en que la
+ * asignación actual y la mejor difieren (a lo sumo n).
+ *
+ * Los flips se registran a mano con registrar() o, si el evaluador lo tiene
+ * enganchado (EvaluadorIncremental::seguirFlips), en cada flip; así también
+ * quedan los que hace un método anidado.
+ */
+class RastroMejor
 {
 private:
-  vector<Clausula> clausulas;
+  int n = 0;
+  vector<int> desdeMejor;   // flips posteriores al mejor, en orden
+  vector<uint64_t> paridad; // área de trabajo de compactar()
+  bool deshaciendo = false;
+
+  void compactar()
+  {
+    paridad.assign((n + 63) / 64, 0);
+    for (int v : desdeMejor)
+      paridad[v >> 6] ^= 1ULL << (v & 63);
+    desdeMejor.clear();
+    for (size_t w = 0; w < paridad.size(); w++)
+      for (uint64_t p = paridad[w]; p; p &= p - 1)
+        desdeMejor.push_back(w * 64 + __builtin_ctzll(p));
+  }
 
 public:
-  Formula() {}
-  Formula(const vector<Clausula> &clauses) { clausulas = clauses; }
+  // Nueva trayectoria: la asignación actual pasa a ser la mejor
+  void reiniciar(int numVariables)
+  {
+    n = numVariables;
+    desdeMejor.clear();
+  }
+
+  void registrar(int v)
+  {
+    if (deshaciendo)
+      return;
+    desdeMejor.push_back(v);
+    if (desdeMejor.size() > 2 * (size_t)n + 64)
+      compactar();
+  }
+
+  void marcarMejor() { desdeMejor.clear(); }
+
+  // Deshace sobre ev los flips posteriores al mejor (sin registrarlos como nuevos)
+  template <class Evaluador>
+  void volverAlMejor(Evaluador &ev)
+  {
+    if (desdeMejor.size() * 16 > (size_t)n)
+      compactar();
+    deshaciendo = true;
+    for (size_t k = desdeMejor.size(); k-- > 0;)
+      ev.flip(desdeMejor[k]);
+    deshaciendo = false;
+    desdeMejor.clear();
+  }
+
+  // Escribe en destino la mejor asignación a partir de la actual
+  void materializar(const AsignacionCompacta &actual, AsignacionCompacta &destino) const
+  {
+    destino = actual;
+    for (int v : desdeMejor)
+      destino.flip(v);
+  }
+};
 
-  int calcularCosto(const vector<TBool> &vars)
+/**
+ * Evaluación incremental de una asignación completa. Mantiene por cláusula la
+ * cantidad de literales verdaderos (y el xor de sus variables, que identifica
+ * a la única verdadera cuando hay una sola) y por variable los puntajes
+ * break/make. Un flip cuesta O(ocurrencias de la variable) y el delta de costo
+ * de cualquier flip se consulta en O(1).
+ */
+class EvaluadorIncremental
+{
+private:
+  const FormulaCompacta &formula;
+  vector<TBool> vars;
+  AsignacionCompacta bits; // copia empaquetada de vars para instantáneas baratas
+  vector<int> numVerdaderos;
+  vector<int> xorVerdaderos;
+  vector<Peso> rompe;  // peso de las cláusulas que pasan a insatisfechas al hacer flip
+  vector<Peso> repara; // peso de las cláusulas insatisfechas que el flip satisface
+  Peso costo = 0;
+  mutable Contadores contadores;
+  RastroMejor *rastro = nullptr; // registra cada flip, si está enganchado
+
+  // Pesos de rompe/repara: los de la fórmula o, con activarPesosDinamicos(), los
+  // propios de un esquema de pesos de cláusulas. costo siempre usa los de la fórmula.
+  const Peso *pesoActivo = nullptr;
+  bool conPesosDinamicos = false;
+  vector<Peso> pesosDinamicos;
+
+  // Cláusulas falsificadas (sin las vacías, que no se pueden reparar) con alta/baja en O(1)
+  vector<int> falsas;
+  vector<int> posFalsa;
+
+  void agregarFalsa(int c)
+  {
+    posFalsa[c] = falsas.size();
+    falsas.push_back(c);
+  }
+
+  void quitarFalsa(int c)
+  {
+    int ultima = falsas.back();
+    falsas[posFalsa[c]] = ultima;
+    posFalsa[ultima] = posFalsa[c];
+    falsas.pop_back();
+  }
+
+  // Registro opcional de las variables cuyo delta cambió desde limpiarCambios()
+  bool registrarCambios = false;
+  vector<int> cambiados;
+  vector<char> enCambiados;
+
+  void marcar(int u)
   {
-    int costo = 0;
-    for (const auto &c : clausulas)
+    if (registrarCambios && !enCambiados[u])
     {
-      if (!c.esSatisfecha(vars))
-        costo++;
+      enCambiados[u] = 1;
+      cambiados.push_back(u);
     }
-    return costo;
   }
 
-  void solverConstructivo(vector<TBool> &variablesGlobales, vector<Conteo> frecs)
+public:
+  EvaluadorIncremental(const FormulaCompacta &f) : formula(f) {}
+  EvaluadorIncremental(const FormulaCompacta &f, const vector<TBool> &asignacion) : formula(f)
   {
-    int variablesPendientes = variablesGlobales.size();
-    while (variablesPendientes > 0)
-    {
-      auto moda = max_element(frecs.begin(), frecs.end(), [](const Conteo &a, const Conteo &b)
-                              { return (a.pos + a.neg) < (b.pos + b.neg); });
+    inicializar(asignacion);
+  }
+  EvaluadorIncremental(const FormulaCompacta &f, const AsignacionCompacta &asignacion) : formula(f)
+  {
+    inicializar(asignacion);
+  }
 
-      if (moda->pos <= 0 && moda->neg <= 0)
-        break;
+  void inicializar(const vector<TBool> &asignacion)
+  {
+    vars = asignacion;
+    bits.empaquetar(vars);
+    recalcular();
+  }
 
-      int idModa = distance(frecs.begin(), moda);
-      bool valor = moda->pos >= moda->neg;
+  void inicializar(const AsignacionCompacta &asignacion)
+  {
+    bits = asignacion;
+    bits.desempaquetar(vars);
+    recalcular();
+  }
 
-      variablesGlobales[idModa] = valor ? TBool::True : TBool::False;
-      moda->pos = -9999;
-      moda->neg = -9999;
+  void recalcular()
+  {
+    contadores.recuentos++;
+    pesoActivo = conPesosDinamicos ? pesosDinamicos.data() : formula.getPesos();
+    int n = vars.size();
+    int m = formula.numClausulas();
+    numVerdaderos.assign(m, 0);
+    xorVerdaderos.assign(m, 0);
+    rompe.assign(n, 0);
+    repara.assign(n, 0);
 
-      for (Clausula &clausula : clausulas)
-      {
-        if (clausula.getSatisfaccion() == TBool::Unknown && clausula.aparece(idModa))
+    for (int v = 0; v < n; v++)
+      for (const int *o = formula.ocurrenciasDe(v), *fin = formula.finOcurrenciasDe(v); o != fin; o++)
+        if (literalVerdadero(*o, vars[v]))
         {
-          clausula.setSatisfaccion(variablesGlobales, &frecs);
+          numVerdaderos[*o >> 1]++;
+          xorVerdaderos[*o >> 1] ^= v;
         }
+
+    costo = 0;
+    falsas.clear();
+    posFalsa.assign(m, -1);
+    for (int c = 0; c < m; c++)
+      if (!formula.esTautologica(c) && numVerdaderos[c] == 0)
+      {
+        costo += formula.peso(c);
+        if (formula.longitud(c) > 0)
+          agregarFalsa(c);
       }
-      variablesPendientes--;
-    }
 
-    for (size_t i = 0; i < variablesGlobales.size(); i++)
-    {
-      if (variablesGlobales[i] == TBool::Unknown)
-        variablesGlobales[i] = TBool::False;
-    }
+    for (int v = 0; v < n; v++)
+      for (const int *o = formula.ocurrenciasDe(v), *fin = formula.finOcurrenciasDe(v); o != fin; o++)
+      {
+        int c = *o >> 1;
+        if (numVerdaderos[c] == 0)
+          repara[v] += pesoActivo[c];
+        else if (numVerdaderos[c] == 1 && xorVerdaderos[c] == v)
+          rompe[v] += pesoActivo[c];
+      }
   }
 
-  void busquedaLocal(vector<TBool> &vars)
+  void flip(int v)
   {
-    bool mejora = true;
-    int costoActual = calcularCosto(vars);
+    despacharAncho(formula.anchoUniforme(), [&](auto k) { flipAncho<decltype(k)::value>(v); });
+    if (rastro)
+      rastro->registrar(v);
+  }
 
-    while (mejora)
+  // Engancha (o suelta, con nullptr) un RastroMejor que recibe todos los flips
+  void seguirFlips(RastroMejor *r) { rastro = r; }
+
+  // Flip con el ancho de cláusula K fijo en compilación (0 = longitudes variables)
+  template <int K>
+  void flipAncho(int v)
+  {
+    contadores.flips++;
+    vars[v] = (vars[v] == TBool::True) ? TBool::False : TBool::True;
+    bits.asignar(v, vars[v] == TBool::True);
+    marcar(v);
+    for (const int *o = formula.ocurrenciasDe(v), *fin = formula.finOcurrenciasDe(v); o != fin; o++)
     {
-      mejora = false;
-      vector<int> candidatos;
-      for (const auto &c : clausulas)
+      int c = *o >> 1;
+      Peso w = pesoActivo[c];
+      if (literalVerdadero(*o, vars[v]))
       {
-        if (!c.esSatisfecha(vars))
+        if (numVerdaderos[c] == 0)
+        {
+          costo -= formula.peso(c);
+          quitarFalsa(c);
+#pragma GCC unroll 4
+          for (const int *l = formula.literalesDe<K>(c), *finC = formula.finDe<K>(c); l != finC; l++)
+          {
+            repara[varDeLiteral(*l)] -= w;
+            marcar(varDeLiteral(*l));
+          }
+          rompe[v] += w;
+        }
+        else if (numVerdaderos[c] == 1)
         {
-          for (int v : c.getVariables())
-            candidatos.push_back(abs(v) - 1);
+          rompe[xorVerdaderos[c]] -= w;
+          marcar(xorVerdaderos[c]);
         }
+        numVerdaderos[c]++;
+        xorVerdaderos[c] ^= v;
       }
-      sort(candidatos.begin(), candidatos.end());
-      candidatos.erase(unique(candidatos.begin(), candidatos.end()), candidatos.end());
-
-      for (int idx : candidatos)
+      else
       {
-        vars[idx] = (vars[idx] == TBool::True) ? TBool::False : TBool::True;
-        int nuevoCosto = calcularCosto(vars);
-        if (nuevoCosto < costoActual)
+        numVerdaderos[c]--;
+        xorVerdaderos[c] ^= v;
+        if (numVerdaderos[c] == 0)
         {
-          costoActual = nuevoCosto;
-          mejora = true;
-          break;
+          costo += formula.peso(c);
+          agregarFalsa(c);
+#pragma GCC unroll 4
+          for (const int *l = formula.literalesDe<K>(c), *finC = formula.finDe<K>(c); l != finC; l++)
+          {
+            repara[varDeLiteral(*l)] += w;
+            marcar(varDeLiteral(*l));
+          }
+          rompe[v] -= w;
         }
-        else
+        else if (numVerdaderos[c] == 1)
         {
-          vars[idx] = (vars[idx] == TBool::True) ? TBool::False : TBool::True; // Revertir
+          rompe[xorVerdaderos[c]] += w;
+          marcar(xorVerdaderos[c]);
         }
       }
     }
   }
 
-  void busquedaLocalIterada(vector<TBool> &vars, int maxIteraciones, mt19937 &gen)
+  void activarRegistroCambios()
   {
-    int mejorCosto = calcularCosto(vars);
-    vector<TBool> mejorSolucion = vars;
-
-    // Distribución uniforme para elegir variables al azar
-    uniform_int_distribution<> dis(0, vars.size() - 1);
-
-    for (int i = 0; i < maxIteraciones; i++)
-    {
-      vector<TBool> actual = mejorSolucion;
+    registrarCambios = true;
+    enCambiados.assign(vars.size(), 0);
+    cambiados.clear();
+  }
 
-      // 1. Perturbación (Random k-flip 5%)
-      int k = max(1, (int)(vars.size() * 0.05));
-      for (int j = 0; j < k; j++)
-      {
-        int idx = dis(gen); // Usamos el generador seguro
-        actual[idx] = (actual[idx] == TBool::True) ? TBool::False : TBool::True;
-      }
+  void desactivarRegistroCambios()
+  {
+    limpiarCambios();
+    registrarCambios = false;
+  }
 
-      // 2. Búsqueda Local
-      busquedaLocal(actual);
+  const vector<int> &getCambiados() const { return cambiados; }
 
-      // 3. Aceptación
-      int costoActual = calcularCosto(actual);
-      if (costoActual < mejorCosto)
-      {
-        mejorCosto = costoActual;
-        mejorSolucion = actual;
-      }
-    }
-    vars = mejorSolucion;
+  void limpiarCambios()
+  {
+    for (int u : cambiados)
+      enCambiados[u] = 0;
+    cambiados.clear();
   }
 
   /**
-   * Estructuras y funciones adicionales para Búsqueda Tabú
+   * Pesos dinámicos de cláusulas (esquemas como PAWS): arrancan en el peso de
+   * la fórmula acotado a 1 y rompe, repara y delta pasan a usarlos; el costo
+   * sigue siendo el real. Cambiar el peso de una cláusula toca solo sus
+   * literales (si está falsificada) o su único literal verdadero.
    */
-
-  // Dentro de la clase Formula:
-  void busquedaTabu(vector<TBool> &vars, int maxIteraciones, int tenureBase) 
+  void activarPesosDinamicos()
   {
-      int n = vars.size();
-      // 1. Estructura de Lista Tabú: almacena la iteración hasta la cual la variable está prohibida
-      vector<int> tabuUntil(n, 0);
-      
-      vector<TBool> mejorSolucionGlobal = vars;
-      int mejorCostoGlobal = calcularCosto(vars);
-      int costoActual = mejorCostoGlobal;
+    pesosDinamicos.resize(formula.numClausulas());
+    for (int c = 0; c < formula.numClausulas(); c++)
+      pesosDinamicos[c] = min<Peso>(formula.peso(c), 1);
+    conPesosDinamicos = true;
+    recalcular();
+  }
 
-      // Generador para tenure variable (opcional pero recomendado)
-      random_device rd;
-      mt19937 gen(rd());
-      uniform_int_distribution<> disTenure(0, 5); // Variación de tenure
+  void desactivarPesosDinamicos()
+  {
+    conPesosDinamicos = false;
+    recalcular();
+  }
 
-      for (int iter = 1; iter <= maxIteraciones; iter++) 
+  void sumarPeso(int c, Peso d)
+  {
+    pesosDinamicos[c] += d;
+    if (numVerdaderos[c] == 0)
+      for (const int *l = formula.literalesDe(c), *fin = formula.finDe(c); l != fin; l++)
       {
-          int mejorVarIdx = -1;
-          int mejorDelta = 1e9; // Buscamos el menor delta (incluso si es positivo/peor)
-
-          // 2. Exploración de la vecindad 1-flip
-          for (int i = 0; i < n; i++) 
-          {
-              // Simular el flip
-              vars[i] = (vars[i] == TBool::True) ? TBool::False : TBool::True;
-              int nuevoCosto = calcularCosto(vars);
-              int delta = nuevoCosto - costoActual;
+        repara[varDeLiteral(*l)] += d;
+        marcar(varDeLiteral(*l));
+      }
+    else if (numVerdaderos[c] == 1)
+    {
+      rompe[xorVerdaderos[c]] += d;
+      marcar(xorVerdaderos[c]);
+    }
+  }
 
-              // 3. Lógica de aceptación con Criterio de Aspiración
-              bool esTabu = (iter < tabuUntil[i]);
-              bool aspira = (nuevoCosto < mejorCostoGlobal);
+  Peso pesoDinamico(int c) const { return pesosDinamicos[c]; }
 
-              if (!esTabu || aspira) 
-              {
-                  if (delta < mejorDelta) 
-                  {
-                      mejorDelta = delta;
-                      mejorVarIdx = i;
-                  }
-              }
-              
-              // Revertir para probar la siguiente variable
-              vars[i] = (vars[i] == TBool::True) ? TBool::False : TBool::True;
+  // Cambio de costo si se hace flip sobre v (negativo = mejora)
+  Peso delta(int v) const
+  {
+    contadores.evaluados++;
+    return rompe[v] - repara[v];
+  }
+  Peso getRompe(int v) const
+  {
+    contadores.evaluados++;
+    return rompe[v];
+  }
+  int numFalsas() const { return falsas.size(); }
+  int falsa(int i) const { return falsas[i]; }
+  Peso getCosto() const { return costo; }
+  int numVariables() const { return vars.size(); }
+  const vector<TBool> &getAsignacion() const { return vars; }
+  // Para tomar una instantánea de la solución (se cuenta como copia)
+  const AsignacionCompacta &getAsignacionCompacta() const
+  {
+    contadores.copias++;
+    return bits;
+  }
+  const Contadores &getContadores() const { return contadores; }
+};
+
+/**
+ * Montículo binario indexado de variables con clave (clave, índice): el tope es
+ * la variable de menor clave (p. ej. el delta de su flip) y, a igualdad, la de
+ * menor índice. Insertar, quitar o cambiar la clave de una variable cuesta
+ * O(log n).
+ */
+class MonticuloMovimientos
+{
+private:
+  vector<int> heap;
+  vector<int> pos; // -1 si la variable no está
+  vector<Peso> clave;
+  mutable vector<int> pila; // auxiliar de recorrerHasta
+
+  bool menor(int a, int b) const { return clave[a] < clave[b] || (clave[a] == clave[b] && a < b); }
+
+  void colocar(int i, int v)
+  {
+    heap[i] = v;
+    pos[v] = i;
+  }
+
+  void subir(int i)
+  {
+    int v = heap[i];
+    while (i > 0 && menor(v, heap[(i - 1) / 2]))
+    {
+      colocar(i, heap[(i - 1) / 2]);
+      i = (i - 1) / 2;
+    }
+    colocar(i, v);
+  }
+
+  void bajar(int i)
+  {
+    int v = heap[i];
+    int n = heap.size();
+    while (2 * i + 1 < n)
+    {
+      int hijo = 2 * i + 1;
+      if (hijo + 1 < n && menor(heap[hijo + 1], heap[hijo]))
+        hijo++;
+      if (!menor(heap[hijo], v))
+        break;
+      colocar(i, heap[hijo]);
+      i = hijo;
+    }
+    colocar(i, v);
+  }
+
+public:
+  void inicializar(int n)
+  {
+    heap.clear();
+    pos.assign(n, -1);
+    clave.assign(n, 0);
+  }
+
+  bool vacio() const { return heap.empty(); }
+  bool contiene(int v) const { return pos[v] >= 0; }
+  int tope() const { return heap[0]; }
+  Peso getClave(int v) const { return clave[v]; }
+
+  void insertar(int v, Peso k)
+  {
+    clave[v] = k;
+    heap.push_back(v);
+    pos[v] = heap.size() - 1;
+    subir(pos[v]);
+  }
+
+  void quitar(int v)
+  {
+    int i = pos[v];
+    int ultimo = heap.back();
+    heap.pop_back();
+    pos[v] = -1;
+    if (ultimo == v)
+      return;
+    colocar(i, ultimo);
+    subir(i);
+    bajar(pos[ultimo]);
+  }
+
+  /**
+   * Visita las variables con clave <= limite (recorrido podado desde la raíz).
+   * Si visita devuelve false el recorrido se corta y la función devuelve false.
+   */
+  template <class Visita>
+  bool recorrerHasta(double limite, Visita visita) const
+  {
+    pila.clear();
+    if (!heap.empty())
+      pila.push_back(0);
+    while (!pila.empty())
+    {
+      int i = pila.back();
+      pila.pop_back();
+      if (clave[heap[i]] > limite)
+        continue;
+      if (!visita(heap[i]))
+        return false;
+      if (2 * i + 1 < (int)heap.size())
+        pila.push_back(2 * i + 1);
+      if (2 * i + 2 < (int)heap.size())
+        pila.push_back(2 * i + 2);
+    }
+    return true;
+  }
+
+  void actualizar(int v, Peso k)
+  {
+    Peso anterior = clave[v];
+    clave[v] = k;
+    if (k < anterior)
+      subir(pos[v]);
+    else if (k > anterior)
+      bajar(pos[v]);
+  }
+};
+
+/**
+ * Mejor costo conocido compartido entre hilos. Es un mínimo atómico sin
+ * bloqueos: leerlo en un ciclo interno cuesta una carga relajada.
+ */
+class MejorConocido
+{
+private:
+  atomic<Peso> costo{numeric_limits<Peso>::max()};
+
+public:
+  Peso get() const { return costo.load(memory_order_relaxed); }
+
+  // true si c mejora el valor compartido
+  bool actualizar(Peso c)
+  {
+    Peso actual = get();
+    while (c < actual)
+      if (costo.compare_exchange_weak(actual, c, memory_order_relaxed))
+        return true;
+    return false;
+  }
+};
+
+/**
+ * Presupuesto de una llamada a un solver. Cada límite en 0 (o costoObjetivo
+ * negativo) queda desactivado; sin ninguno activo los solvers paran solo por
+ * sus propios contadores de iteraciones.
+ */
+struct Presupuesto
+{
+  double segundos = 0;        // tiempo de reloj desde que se crea el control
+  long long maxFlips = 0;     // pasos del ciclo interno (flips o movimientos evaluados)
+  Peso costoObjetivo = -1;    // se detiene al llegar a un costo <= objetivo
+  long long maxSinMejora = 0; // pasos seguidos sin mejorar el mejor costo
+};
+
+/**
+ * Estado de terminación compartido por las tareas de un solver. avanzar(k)
+ * suma k pasos, revisa todos los límites (reloj y mejor costo de otros nodos
+ * incluidos) y devuelve cuántos pasos más pueden darse antes de volver a
+ * revisar: hasta PASOS_POR_REVISION, sin pasarse de maxFlips ni de
+ * maxSinMejora. Los ciclos internos no lo llaman en cada flip sino a través
+ * de PasosLocales; continuar(k) es la forma directa para los puntos de control
+ * (k = 0) y los bloques de pasos. reportar() registra un nuevo mejor costo en
+ * el mínimo atómico; alMejorar no se llama ahí sino en la siguiente revisión
+ * (con try_lock) o en avisarPendiente(), para que ningún ciclo interno tome
+ * un mutex.
+ */
+class ControlBusqueda
+{
+private:
+  Presupuesto presupuesto;
+  chrono::steady_clock::time_point inicio;
+  atomic<long long> pasos{0};
+  atomic<long long> pasoUltimaMejora{0};
+  atomic<bool> detenido{false};
+  MejorConocido mejor;
+  const MejorConocido *externo; // mejor costo de otros nodos (--mejores), en costo de la fórmula original
+  Peso desplazamiento;          // costo original = costo de la búsqueda + desplazamiento
+  function<void(Peso, double)> alMejorar;
+  mutex mtxAviso;
+  Peso ultimoAvisado = numeric_limits<Peso>::max();
+  atomic<double> segundosMejor{0};
+  atomic<bool> avisoPendiente{false};
+  mutex mtxContadores;
+  Contadores contadores;
+
+  // Llama a alMejorar con el mejor costo si no se avisó todavía; sin esperar
+  // el mutex si otro hilo ya está avisando (lo verá en su siguiente revisión)
+  void avisar(bool esperar)
+  {
+    unique_lock<mutex> lock(mtxAviso, defer_lock);
+    if (esperar)
+      lock.lock();
+    else if (!lock.try_lock())
+      return;
+    if (!avisoPendiente.exchange(false, memory_order_relaxed))
+      return;
+    Peso costo = mejor.get();
+    if (costo < ultimoAvisado)
+    {
+      ultimoAvisado = costo;
+      alMejorar(costo, segundosMejor.load(memory_order_relaxed));
+    }
+  }
+
+public:
+  static const long long PASOS_POR_REVISION = 1024;
+
+  explicit ControlBusqueda(const Presupuesto &p = Presupuesto(), function<void(Peso, double)> aviso = nullptr,
+                           const MejorConocido *mejorExterno = nullptr, Peso desplazamientoExterno = 0)
+      : presupuesto(p), inicio(chrono::steady_clock::now()), externo(mejorExterno), desplazamiento(desplazamientoExterno),
+        alMejorar(move(aviso)) {}
+
+  // true si algún límite (además del costo objetivo) puede cortar la búsqueda
+  bool limitado() const { return presupuesto.segundos > 0 || presupuesto.maxFlips > 0 || presupuesto.maxSinMejora > 0; }
+
+  double segundos() const { return chrono::duration<double>(chrono::steady_clock::now() - inicio).count(); }
+
+  ~ControlBusqueda() { avisarPendiente(); }
+
+  // Cuenta k pasos y revisa los límites; pasos que quedan hasta la próxima revisión (0 si se agotó)
+  long long avanzar(long long k)
+  {
+    if (detenido.load(memory_order_relaxed))
+      return 0;
+    long long ahora = pasos.fetch_add(k, memory_order_relaxed) + k;
+    long long sinMejora = ahora - pasoUltimaMejora.load(memory_order_relaxed);
+    if ((presupuesto.maxFlips > 0 && ahora >= presupuesto.maxFlips) ||
+        (presupuesto.maxSinMejora > 0 && sinMejora >= presupuesto.maxSinMejora) ||
+        (presupuesto.segundos > 0 && segundos() >= presupuesto.segundos) ||
+        (externo && presupuesto.costoObjetivo >= 0 && externo->get() - desplazamiento <= presupuesto.costoObjetivo))
+    {
+      detenido.store(true, memory_order_relaxed);
+      return 0;
+    }
+    if (avisoPendiente.load(memory_order_relaxed))
+      avisar(false);
+    long long margen = PASOS_POR_REVISION;
+    if (presupuesto.maxFlips > 0)
+      margen = min(margen, presupuesto.maxFlips - ahora);
+    if (presupuesto.maxSinMejora > 0)
+      margen = min(margen, presupuesto.maxSinMejora - sinMejora);
+    return margen;
+  }
+
+  // Cuenta k pasos (0 en un punto de control); false si el presupuesto se agotó
+  bool continuar(long long k) { return avanzar(k) > 0; }
+
+  // Nuevo costo encontrado; pendientes son los pasos que quien reporta aún no volcó
+  void reportar(Peso costo, long long pendientes = 0)
+  {
+    if (!mejor.actualizar(costo))
+      return;
+    pasoUltimaMejora.store(pasos.load(memory_order_relaxed) + pendientes, memory_order_relaxed);
+    segundosMejor.store(segundos(), memory_order_relaxed);
+    if (costo <= presupuesto.costoObjetivo)
+      detenido.store(true, memory_order_relaxed);
+    if (alMejorar)
+      avisoPendiente.store(true, memory_order_relaxed);
+  }
+
+  // Avisa ya la última mejora si quedó pendiente (al terminar un método)
+  void avisarPendiente()
+  {
+    if (alMejorar && avisoPendiente.load(memory_order_relaxed))
+      avisar(true);
+  }
+
+  bool agotado() const { return detenido.load(memory_order_relaxed); }
+
+  // Fracción gastada del presupuesto de flips o de tiempo (la mayor); -1 si no tiene ninguno
+  double progreso() const
+  {
+    double p = -1;
+    if (presupuesto.maxFlips > 0)
+      p = (double)pasos.load(memory_order_relaxed) / presupuesto.maxFlips;
+    if (presupuesto.segundos > 0)
+      p = max(p, segundos() / presupuesto.segundos);
+    return p;
+  }
+  long long getPasos() const { return pasos.load(memory_order_relaxed); }
+  double getSegundosMejor() const { return segundosMejor.load(memory_order_relaxed); }
+
+  // Suma el trabajo de una tarea (su evaluador) al del método
+  void acumular(const Contadores &c)
+  {
+    lock_guard<mutex> lock(mtxContadores);
+    contadores += c;
+  }
+
+  Contadores getContadores()
+  {
+    lock_guard<mutex> lock(mtxContadores);
+    return contadores;
+  }
+};
+
+/**
+ * Contador de pasos de un solo hilo sobre un ControlBusqueda: el ciclo interno
+ * suma en un entero propio y solo vuelca al control compartido cuando gasta el
+ * margen de la última revisión; entre medio lee apenas agotado(). Con un solo
+ * hilo los límites de pasos se cumplen exactos; con varios trabajadores sobre
+ * el mismo control cada uno puede pasarse a lo sumo en su margen (1024 pasos).
+ */
+class PasosLocales
+{
+private:
+  ControlBusqueda &control;
+  long long pendientes = 0;
+  long long margen = 0; // 0: revisar en el próximo paso
+
+public:
+  explicit PasosLocales(ControlBusqueda &c) : control(c) {}
+  ~PasosLocales()
+  {
+    if (pendientes > 0)
+      control.avanzar(pendientes);
+  }
+
+  // Cuenta un paso; false si el presupuesto se agotó
+  bool continuar()
+  {
+    if (control.agotado())
+      return false;
+    if (++pendientes < margen)
+      return true;
+    margen = control.avanzar(pendientes);
+    pendientes = 0;
+    return margen > 0;
+  }
+
+  void reportar(Peso costo) { control.reportar(costo, pendientes); }
+};
+
+/**
+ * Pool de soluciones élite compartido por trabajadores concurrentes. Cada
+ * casilla es un puntero inmutable que se lee y reemplaza con las operaciones
+ * atómicas de shared_ptr: quien lee conserva su copia aunque otro hilo
+ * publique encima. En libstdc++ esas operaciones toman un mutex interno (no
+ * son lock-free), lo que basta porque solo se usan en los cambios de periodo.
+ */
+class PoolElite
+{
+public:
+  struct Entrada
+  {
+    Peso costo;
+    AsignacionCompacta vars;
+  };
+
+private:
+  vector<shared_ptr<const Entrada>> casillas;
+
+public:
+  explicit PoolElite(int capacidad) : casillas(capacidad) {}
+
+  // Reemplaza la peor casilla si costo la mejora
+  void publicar(Peso costo, const AsignacionCompacta &vars)
+  {
+    shared_ptr<const Entrada> nueva;
+    while (true)
+    {
+      int peor = -1;
+      Peso costoPeor = numeric_limits<Peso>::min();
+      shared_ptr<const Entrada> actual;
+      for (size_t i = 0; i < casillas.size(); i++)
+      {
+        auto e = atomic_load(&casillas[i]);
+        Peso c = e ? e->costo : numeric_limits<Peso>::max();
+        if (c > costoPeor)
+        {
+          costoPeor = c;
+          peor = i;
+          actual = e;
+        }
+      }
+      if (costo >= costoPeor)
+        return;
+      if (!nueva)
+        nueva = make_shared<const Entrada>(Entrada{costo, vars});
+      if (atomic_compare_exchange_strong(&casillas[peor], &actual, nueva))
+        return;
+    }
+  }
+
+  shared_ptr<const Entrada> mejor() const
+  {
+    shared_ptr<const Entrada> mejorEntrada;
+    for (const auto &casilla : casillas)
+    {
+      auto e = atomic_load(&casilla);
+      if (e && (!mejorEntrada || e->costo < mejorEntrada->costo))
+        mejorEntrada = e;
+    }
+    return mejorEntrada;
+  }
+
+  // Élite al azar: la mejor con probabilidad 1/2, otra casilla ocupada en otro caso
+  shared_ptr<const Entrada> elegir(Generador &gen) const
+  {
+    if (gen() & 1)
+      return mejor();
+    auto e = atomic_load(&casillas[gen() % casillas.size()]);
+    return e ? e : mejor();
+  }
+};
+
+enum class PoliticaSLS
+{
+  WalkSAT,
+  ProbSAT,
+  PAWS // pesos dinámicos de cláusulas
+};
+
+/**
+ * Parámetros de la búsqueda local focalizada. ruido es la probabilidad de paso
+ * aleatorio de WalkSAT; cb y eps definen la función polinomial de ProbSAT,
+ * f(break) = (eps + break)^-cb (cb = 2.38, eps = 1 para 3-SAT en el artículo).
+ * plano y periodoDecremento son los de PAWS (0.15 y 10 en el artículo).
+ */
+struct ParametrosSLS
+{
+  PoliticaSLS politica = PoliticaSLS::ProbSAT;
+  double ruido = 0.567;
+  double cb = 2.38;
+  double eps = 1.0;
+  double plano = 0.15;
+  int periodoDecremento = 10;
+};
+
+enum class EnfriamientoSA
+{
+  Geometrico, // T *= alpha en cada nivel
+  Adaptativo  // alpha se ajusta según la tasa de aceptación de movimientos peores
+};
+
+/**
+ * Parámetros del recocido simulado. tasaObjetivo guía el enfriamiento
+ * adaptativo; nivelesSinMejora = 0 desactiva el recalentamiento, que lleva T a
+ * factorRecalentamiento * tempInicial.
+ */
+struct ParametrosSA
+{
+  double tempInicial = 10.0;
+  double tempMinima = 0.01;
+  double alpha = 0.98;
+  int iterPorTemp = 100;
+  EnfriamientoSA enfriamiento = EnfriamientoSA::Geometrico;
+  double tasaObjetivo = 0.3;
+  int nivelesSinMejora = 0;
+  double factorRecalentamiento = 0.5;
+  int maxRecalentamientos = 3;
+};
+
+/**
+ * Memoria de trabajo reutilizable de una tarea: el evaluador incremental, los
+ * montículos y los buffers auxiliares de las metaheurísticas. Se dimensiona en
+ * el primer uso y después solo se reasigna dentro de la capacidad ya reservada,
+ * así el ciclo de búsqueda no pide memoria al asignador (que contendería entre
+ * los hilos). No se comparte: cada tarea OpenMP toma el suyo de un PoolEspacios.
+ */
+struct EspacioTrabajo
+{
+  EvaluadorIncremental ev;
+  AsignacionCompacta mejorSolucion; // mejor solución de la metaheurística, materializada
+  RastroMejor rastro;               // flips desde la mejor solución de la metaheurística
+  RastroMejor rastroPaso;           // ídem dentro de un paso de LS focalizada
+  vector<TBool> asignacion;         // solución en construcción (GRASP)
+  vector<TBool> estadoClausulas;
+  vector<Conteo> frecs;
+  MonticuloMovimientos monticulos[2];
+  vector<int> pendientes, posPendiente, rcl;
+  vector<double> acumulada;
+  vector<int> tabuHasta;
+  vector<vector<int>> vencimientos;
+  vector<int> mejoran, posMejoran, pesadas, posPesada; // PAWS
+
+  explicit EspacioTrabajo(const FormulaCompacta &f) : ev(f) {}
+};
+
+/**
+ * Reserva de espacios de trabajo de una fórmula. prestar() devuelve uno libre
+ * (o crea uno nuevo si no hay) y el préstamo lo devuelve al destruirse. En
+ * régimen hay tantos espacios como tareas simultáneas y ninguno se libera.
+ */
+class PoolEspacios
+{
+private:
+  const FormulaCompacta &formula;
+  mutex mtx;
+  vector<unique_ptr<EspacioTrabajo>> libres;
+
+public:
+  class Prestamo
+  {
+  private:
+    PoolEspacios *pool;
+    unique_ptr<EspacioTrabajo> espacio;
+
+  public:
+    Prestamo(PoolEspacios *p, unique_ptr<EspacioTrabajo> e) : pool(p), espacio(move(e)) {}
+    Prestamo(Prestamo &&) = default;
+    ~Prestamo()
+    {
+      if (espacio)
+        pool->devolver(move(espacio));
+    }
+    EspacioTrabajo &operator*() const { return *espacio; }
+  };
+
+  explicit PoolEspacios(const FormulaCompacta &f) : formula(f) {}
+
+  Prestamo prestar()
+  {
+    {
+      lock_guard<mutex> lock(mtx);
+      if (!libres.empty())
+      {
+        unique_ptr<EspacioTrabajo> e = move(libres.back());
+        libres.pop_back();
+        return Prestamo(this, move(e));
+      }
+    }
+    return Prestamo(this, make_unique<EspacioTrabajo>(formula));
+  }
+
+  void devolver(unique_ptr<EspacioTrabajo> e)
+  {
+    lock_guard<mutex> lock(mtx);
+    libres.push_back(move(e));
+  }
+};
+
+class Formula
+{
+private:
+  const FormulaCompacta &formula;
+  mutable PoolEspacios espacios;
+
+  // Paso de búsqueda local de ILS y GRASP: primera mejora o focalizada
+  bool lsFocalizada = false;
+  ParametrosSLS parametrosLS;
+  long long flipsPorPaso = 0;
+
+  /**
+   * Marca la cláusula c como satisfecha o falsificada si ya se puede decidir con
+   * la asignación parcial, y descuenta sus literales de las frecuencias
+   * (avisando a alCambiar por cada variable descontada).
+   */
+  template <class AlCambiar>
+  void actualizarEstado(int c, vector<TBool> &estado, const vector<TBool> &variablesGlobales, vector<Conteo> &frecs,
+                        AlCambiar &alCambiar) const
+  {
+    bool esperanza = false;
+    for (const int *l = formula.literalesDe(c), *fin = formula.finDe(c); l != fin; l++)
+    {
+      TBool valorVar = variablesGlobales[varDeLiteral(*l)];
+      if (literalVerdadero(*l, valorVar))
+      {
+        estado[c] = TBool::True;
+        descontarFrecuencias(c, frecs, alCambiar);
+        return;
+      }
+      if (valorVar == TBool::Unknown)
+        esperanza = true;
+    }
+
+    if (!esperanza)
+    {
+      estado[c] = TBool::False;
+      descontarFrecuencias(c, frecs, alCambiar);
+    }
+  }
+
+  template <class AlCambiar>
+  void descontarFrecuencias(int c, vector<Conteo> &frecs, AlCambiar &alCambiar) const
+  {
+    Peso w = formula.peso(c);
+    for (const int *l = formula.literalesDe(c), *fin = formula.finDe(c); l != fin; l++)
+    {
+      if (esNegado(*l))
+        frecs[varDeLiteral(*l)].neg -= w;
+      else
+        frecs[varDeLiteral(*l)].pos -= w;
+      alCambiar(varDeLiteral(*l));
+    }
+  }
+
+  // Decide, vía el índice de ocurrencias, las cláusulas aún abiertas que contienen a v
+  template <class AlCambiar>
+  void propagarAsignacion(int v, vector<TBool> &estado, const vector<TBool> &variablesGlobales, vector<Conteo> &frecs,
+                          AlCambiar alCambiar) const
+  {
+    for (const int *o = formula.ocurrenciasDe(v), *fin = formula.finOcurrenciasDe(v); o != fin; o++)
+      if (estado[*o >> 1] == TBool::Unknown)
+        actualizarEstado(*o >> 1, estado, variablesGlobales, frecs, alCambiar);
+  }
+
+public:
+  Formula(const FormulaCompacta &f) : formula(f), espacios(f) {}
+
+  // Espacio de trabajo para una tarea (una corrida, un arranque, un trabajador)
+  PoolEspacios::Prestamo prestarEspacio() const { return espacios.prestar(); }
+
+  // Usa la búsqueda focalizada (con flips flips) como paso de LS de ILS y GRASP
+  void usarBusquedaFocalizada(const ParametrosSLS &parametros, long long flips)
+  {
+    lsFocalizada = true;
+    parametrosLS = parametros;
+    flipsPorPaso = flips;
+  }
+
+  // Suma de pesos de las cláusulas falsificadas (las duras pesan getPesoDuro())
+  Peso calcularCosto(const vector<TBool> &vars) const
+  {
+    return calcularCosto(AsignacionCompacta(vars));
+  }
+
+  /**
+   * Recuento completo sobre la asignación empaquetada. En fórmulas de ancho 3
+   * compiladas con AVX2 o AVX-512 se evalúan 8 o 16 cláusulas por instrucción;
+   * el resto de las cláusulas (y las demás fórmulas) usa la tabla escalar.
+   */
+  Peso calcularCosto(const AsignacionCompacta &vars) const
+  {
+    TablaLiterales tabla(vars);
+    Peso costo = 0;
+    int c = 0;
+#if defined(__AVX2__) || defined(__AVX512F__)
+    if (formula.anchoUniforme() == 3)
+      for (int m = formula.numClausulas(); c + BLOQUE_ANCHO3 <= m; c += BLOQUE_ANCHO3)
+        for (unsigned falsas = falsificadasAncho3(formula.getLiterales(), c, tabla); falsas; falsas &= falsas - 1)
+        {
+          int d = c + __builtin_ctz(falsas);
+          if (!formula.esTautologica(d))
+            costo += formula.peso(d);
+        }
+#endif
+    despacharAncho(formula.anchoUniforme(), [&](auto k) { costo += costoDesde<decltype(k)::value>(tabla, c); });
+    return costo;
+  }
+
+  // Costo de las cláusulas [c, m); con K > 0 el recorrido de los K literales queda desenrollado
+  template <int K>
+  Peso costoDesde(const TablaLiterales &tabla, int c) const
+  {
+    Peso costo = 0;
+    for (int m = formula.numClausulas(); c < m; c++)
+    {
+      if (formula.esTautologica(c))
+        continue;
+      bool satisfecha = false;
+      if (K > 0)
+      {
+        const int *l = formula.literalesDe<K>(c);
+#pragma GCC unroll 4
+        for (int j = 0; j < K && !satisfecha; j++)
+          satisfecha = tabla.verdadero(l[j]);
+      }
+      else
+        for (const int *l = formula.literalesDe(c), *fin = formula.finDe(c); l != fin && !satisfecha; l++)
+          satisfecha = tabla.verdadero(*l);
+      if (!satisfecha)
+        costo += formula.peso(c);
+    }
+    return costo;
+  }
+
+  /**
+   * Heurística constructiva: asigna primero la variable con más apariciones
+   * ponderadas en cláusulas abiertas (pos + neg) a su polaridad dominante. Las
+   * variables esperan en un montículo por -(pos + neg) que se actualiza cuando
+   * sus cláusulas quedan decididas; cada cláusula se decide una vez, así que la
+   * construcción cuesta O(literales · log n).
+   *
+   * Las variables que ya llegan con valor (un arranque en caliente) se
+   * respetan: deciden sus cláusulas antes de empezar y solo se construyen las
+   * que faltan.
+   */
+  void solverConstructivo(vector<TBool> &variablesGlobales, const vector<Conteo> &frecsIniciales, EspacioTrabajo &ws)
+  {
+    int n = variablesGlobales.size();
+    vector<Conteo> &frecs = ws.frecs;
+    frecs.assign(frecsIniciales.begin(), frecsIniciales.end());
+    vector<TBool> &estado = ws.estadoClausulas;
+    estado.assign(formula.numClausulas(), TBool::Unknown);
+    MonticuloMovimientos &cola = ws.monticulos[0];
+    cola.inicializar(n);
+    for (int v = 0; v < n; v++)
+      if (variablesGlobales[v] == TBool::Unknown)
+        cola.insertar(v, -(frecs[v].pos + frecs[v].neg));
+    for (int v = 0; v < n; v++)
+      if (variablesGlobales[v] != TBool::Unknown)
+        propagarAsignacion(v, estado, variablesGlobales, frecs, [&](int u)
+                           {
+                             if (cola.contiene(u))
+                               cola.actualizar(u, -(frecs[u].pos + frecs[u].neg));
+                           });
+
+    while (!cola.vacio())
+    {
+      int idModa = cola.tope();
+      const Conteo &moda = frecs[idModa];
+      if (moda.pos <= 0 && moda.neg <= 0)
+        break;
+
+      bool valor = moda.pos >= moda.neg;
+      variablesGlobales[idModa] = valor ? TBool::True : TBool::False;
+      cola.quitar(idModa);
+
+      propagarAsignacion(idModa, estado, variablesGlobales, frecs, [&](int u)
+                         {
+                           if (cola.contiene(u))
+                             cola.actualizar(u, -(frecs[u].pos + frecs[u].neg));
+                         });
+    }
+
+    for (size_t i = 0; i < variablesGlobales.size(); i++)
+    {
+      if (variablesGlobales[i] == TBool::Unknown)
+        variablesGlobales[i] = TBool::False;
+    }
+  }
+
+  /**
+   * Búsqueda local de primera mejora: hace flip sobre la primera variable
+   * (en orden de índice) cuyo delta mejora el costo, hasta un óptimo local.
+   */
+  void busquedaLocal(EvaluadorIncremental &ev, ControlBusqueda &control) const
+  {
+    int n = ev.numVariables();
+    bool mejora = true;
+    PasosLocales pasos(control);
+    while (mejora && pasos.continuar())
+    {
+      mejora = false;
+      for (int idx = 0; idx < n; idx++)
+      {
+        if (ev.delta(idx) < 0)
+        {
+          ev.flip(idx);
+          pasos.reportar(ev.getCosto());
+          mejora = true;
+          break;
+        }
+      }
+    }
+  }
+
+  /**
+   * Búsqueda con pesos dinámicos de cláusulas al estilo PAWS (Thornton et al.),
+   * sobre los puntajes incrementales del evaluador. En cada paso hace flip a la
+   * variable de menor delta ponderado entre las que mejoran, que se mantienen
+   * en un conjunto con el registro de cambios del evaluador. En un mínimo local
+   * toma con probabilidad parametros.plano un movimiento de delta 0 de una
+   * cláusula falsificada; si no, suma 1 al peso de cada falsificada, y cada
+   * parametros.periodoDecremento aumentos resta 1 a las cláusulas con peso > 1.
+   * Ajustar un peso cuesta O(literales de la cláusula). La mejor asignación
+   * (con los pesos reales) se sigue con ws.rastroPaso, y al terminar ev queda
+   * en ella con los pesos de la fórmula.
+   */
+  void busquedaPesosDinamicos(EspacioTrabajo &ws, long long maxFlips, const ParametrosSLS &parametros,
+                              Generador &gen, ControlBusqueda &control)
+  {
+    EvaluadorIncremental &ev = ws.ev;
+    int n = ev.numVariables();
+    int m = formula.numClausulas();
+    Peso mejorCosto = ev.getCosto();
+    RastroMejor &rastro = ws.rastroPaso;
+    rastro.reiniciar(n);
+    uniform_real_distribution<> probDist(0.0, 1.0);
+
+    ev.activarPesosDinamicos();
+    ev.activarRegistroCambios();
+    // Conjunto de variables que mejoran (delta < 0) y de cláusulas con peso > 1
+    vector<int> &mejoran = ws.mejoran, &posMejoran = ws.posMejoran;
+    vector<int> &pesadas = ws.pesadas, &posPesada = ws.posPesada;
+    mejoran.clear();
+    posMejoran.assign(n, -1);
+    pesadas.clear();
+    posPesada.assign(m, -1);
+    auto revisar = [&](int v)
+    {
+      bool mejora = ev.delta(v) < 0;
+      if (mejora && posMejoran[v] < 0)
+      {
+        posMejoran[v] = mejoran.size();
+        mejoran.push_back(v);
+      }
+      else if (!mejora && posMejoran[v] >= 0)
+      {
+        int ultima = mejoran.back();
+        mejoran[posMejoran[v]] = ultima;
+        posMejoran[ultima] = posMejoran[v];
+        mejoran.pop_back();
+        posMejoran[v] = -1;
+      }
+    };
+    auto actualizarCambiados = [&]()
+    {
+      for (int u : ev.getCambiados())
+        revisar(u);
+      ev.limpiarCambios();
+    };
+    for (int v = 0; v < n; v++)
+      revisar(v);
+
+    long long aumentos = 0;
+    PasosLocales pasos(control);
+    for (long long f = 0; f < maxFlips && ev.numFalsas() > 0 && pasos.continuar(); f++)
+    {
+      int elegida = -1;
+      if (!mejoran.empty())
+      {
+        // Menor delta ponderado; los empates se resuelven al azar (muestreo de reservorio)
+        Peso menor = 0;
+        int empates = 0;
+        for (int v : mejoran)
+        {
+          Peso d = ev.delta(v);
+          if (d < menor || elegida < 0)
+          {
+            menor = d;
+            elegida = v;
+            empates = 1;
+          }
+          else if (d == menor && gen() % ++empates == 0)
+            elegida = v;
+        }
+      }
+      else if (probDist(gen) < parametros.plano)
+      {
+        // Movimiento plano: una variable de delta 0 de una cláusula falsificada al azar
+        int c = ev.falsa(uniform_int_distribution<>(0, ev.numFalsas() - 1)(gen));
+        for (const int *l = formula.literalesDe(c), *fin = formula.finDe(c); l != fin && elegida < 0; l++)
+          if (ev.delta(varDeLiteral(*l)) == 0)
+            elegida = varDeLiteral(*l);
+      }
+
+      if (elegida < 0)
+      {
+        // Mínimo local: más peso a las falsificadas y, periódicamente, menos al resto
+        for (int i = 0; i < ev.numFalsas(); i++)
+        {
+          int c = ev.falsa(i);
+          ev.sumarPeso(c, 1);
+          if (posPesada[c] < 0 && ev.pesoDinamico(c) > 1)
+          {
+            posPesada[c] = pesadas.size();
+            pesadas.push_back(c);
+          }
+        }
+        if (++aumentos % parametros.periodoDecremento == 0)
+          for (size_t i = pesadas.size(); i-- > 0;)
+          {
+            int c = pesadas[i];
+            ev.sumarPeso(c, -1);
+            if (ev.pesoDinamico(c) <= 1)
+            {
+              int ultima = pesadas.back();
+              pesadas[i] = ultima;
+              posPesada[ultima] = i;
+              pesadas.pop_back();
+              posPesada[c] = -1;
+            }
+          }
+        actualizarCambiados();
+        continue;
+      }
+
+      ev.flip(elegida);
+      rastro.registrar(elegida);
+      actualizarCambiados();
+      if (ev.getCosto() < mejorCosto)
+      {
+        mejorCosto = ev.getCosto();
+        rastro.marcarMejor();
+        pasos.reportar(mejorCosto);
+      }
+    }
+
+    ev.desactivarRegistroCambios();
+    if (ev.getCosto() > mejorCosto)
+      rastro.volverAlMejor(ev);
+    ev.desactivarPesosDinamicos();
+  }
+
+  /**
+   * Búsqueda local focalizada estilo WalkSAT/ProbSAT: en cada paso toma al azar
+   * una cláusula falsificada y hace flip sobre uno de sus literales según su
+   * puntaje break. Termina al agotar maxFlips o sin cláusulas falsificadas, y
+   * deja ev en la mejor asignación encontrada.
+   */
+  void busquedaFocalizada(EspacioTrabajo &ws, long long maxFlips, const ParametrosSLS &parametros, Generador &gen,
+                          ControlBusqueda &control)
+  {
+    if (parametros.politica == PoliticaSLS::PAWS)
+    {
+      busquedaPesosDinamicos(ws, maxFlips, parametros, gen, control);
+      return;
+    }
+    EvaluadorIncremental &ev = ws.ev;
+    Peso mejorCosto = ev.getCosto();
+    RastroMejor &rastro = ws.rastroPaso;
+    rastro.reiniciar(ev.numVariables());
+    uniform_real_distribution<> probDist(0.0, 1.0);
+
+    // f(break) para breaks enteros pequeños; los demás (pesos grandes) se calculan al vuelo
+    const int TAM_TABLA = 64;
+    double tabla[TAM_TABLA];
+    for (int b = 0; b < TAM_TABLA; b++)
+      tabla[b] = pow(parametros.eps + b, -parametros.cb);
+    vector<double> &acumulada = ws.acumulada;
+
+    PasosLocales pasos(control);
+    for (long long f = 0; f < maxFlips && ev.numFalsas() > 0 && pasos.continuar(); f++)
+    {
+      int c = ev.falsa(uniform_int_distribution<>(0, ev.numFalsas() - 1)(gen));
+      const int *lits = formula.literalesDe(c);
+      int k = formula.longitud(c);
+      int elegida = -1;
+
+      if (parametros.politica == PoliticaSLS::WalkSAT)
+      {
+        // Movimiento gratis (break 0) si existe; si no, paso aleatorio con prob. ruido o menor break
+        Peso menorBreak = numeric_limits<Peso>::max();
+        for (int j = 0; j < k; j++)
+        {
+          Peso b = ev.getRompe(varDeLiteral(lits[j]));
+          if (b < menorBreak)
+          {
+            menorBreak = b;
+            elegida = varDeLiteral(lits[j]);
+          }
+        }
+        if (menorBreak > 0 && probDist(gen) < parametros.ruido)
+          elegida = varDeLiteral(lits[uniform_int_distribution<>(0, k - 1)(gen)]);
+      }
+      else
+      {
+        acumulada.resize(k);
+        double suma = 0.0;
+        for (int j = 0; j < k; j++)
+        {
+          Peso b = ev.getRompe(varDeLiteral(lits[j]));
+          suma += (b < TAM_TABLA) ? tabla[b] : pow(parametros.eps + b, -parametros.cb);
+          acumulada[j] = suma;
+        }
+        double r = probDist(gen) * suma;
+        int j = 0;
+        while (j < k - 1 && acumulada[j] <= r)
+          j++;
+        elegida = varDeLiteral(lits[j]);
+      }
+
+      ev.flip(elegida);
+      rastro.registrar(elegida);
+      if (ev.getCosto() < mejorCosto)
+      {
+        mejorCosto = ev.getCosto();
+        rastro.marcarMejor();
+        pasos.reportar(mejorCosto);
+      }
+    }
+
+    if (ev.getCosto() > mejorCosto)
+      rastro.volverAlMejor(ev);
+  }
+
+  void busquedaFocalizada(vector<TBool> &vars, long long maxFlips, const ParametrosSLS &parametros, Generador &gen,
+                          EspacioTrabajo &ws, ControlBusqueda &control)
+  {
+    ws.ev.inicializar(vars);
+    control.reportar(ws.ev.getCosto());
+    busquedaFocalizada(ws, maxFlips, parametros, gen, control);
+    vars = ws.ev.getAsignacion();
+  }
+
+  // Paso de mejora de ILS y GRASP (sobre ws.ev) según la configuración
+  void pasoBusquedaLocal(EspacioTrabajo &ws, Generador &gen, ControlBusqueda &control)
+  {
+    if (lsFocalizada)
+      busquedaFocalizada(ws, flipsPorPaso, parametrosLS, gen, control);
+    else
+      busquedaLocal(ws.ev, control);
+  }
+
+  void busquedaLocal(vector<TBool> &vars, EspacioTrabajo &ws, ControlBusqueda &control)
+  {
+    ws.ev.inicializar(vars);
+    control.reportar(ws.ev.getCosto());
+    busquedaLocal(ws.ev, control);
+    vars = ws.ev.getAsignacion();
+  }
+
+  void busquedaLocalIterada(vector<TBool> &vars, int maxIteraciones, Generador &gen, EspacioTrabajo &ws,
+                           ControlBusqueda &control)
+  {
+    EvaluadorIncremental &ev = ws.ev;
+    ev.inicializar(vars);
+    Peso mejorCosto = ev.getCosto();
+    control.reportar(mejorCosto);
+    // Todos los flips (perturbación y paso de LS) quedan en el rastro: volver al
+    // mejor deshace solo los de la última iteración
+    RastroMejor &rastro = ws.rastro;
+    rastro.reiniciar(ev.numVariables());
+    ev.seguirFlips(&rastro);
+
+    // Distribución uniforme para elegir variables al azar
+    uniform_int_distribution<> dis(0, vars.size() - 1);
+
+    for (int i = 0; i < maxIteraciones && control.continuar(0); i++)
+    {
+      if (i > 0)
+        rastro.volverAlMejor(ev);
+
+      // 1. Perturbación (Random k-flip 5%)
+      int k = max(1, (int)(vars.size() * 0.05));
+      for (int j = 0; j < k; j++)
+      {
+        int idx = dis(gen); // Usamos el generador seguro
+        ev.flip(idx);
+      }
+      control.continuar(k);
+
+      // 2. Búsqueda Local
+      pasoBusquedaLocal(ws, gen, control);
+
+      // 3. Aceptación
+      Peso costoActual = ev.getCosto();
+      if (costoActual < mejorCosto)
+      {
+        mejorCosto = costoActual;
+        rastro.marcarMejor();
+      }
+    }
+    ev.seguirFlips(nullptr);
+    rastro.volverAlMejor(ev);
+    vars = ev.getAsignacion();
+  }
+
+  /**
+   * Estructuras y funciones adicionales para Búsqueda Tabú
+   */
+
+  /**
+   * Trayectoria tabú 1-flip sobre ev con criterio de aspiración. Las variables
+   * libres y las tabú viven en dos montículos por delta; los vencimientos de la
+   * lista tabú se guardan en un anillo de cubetas por iteración. Así cada
+   * iteración solo toca las variables cuyo delta cambió con el flip, en lugar
+   * de recorrer las n. La elección coincide con el recorrido lineal: menor
+   * delta admisible y, a igualdad, menor índice.
+   *
+   * Si periodo > 0, cada periodo iteraciones se llama a intercambio(ev,
+   * mejorCosto, mejorSolucion), que puede publicar la mejor solución o mover el
+   * punto actual (y entonces devuelve true). La mejor solución se sigue con
+   * ws.rastro y solo se materializa en ws.mejorSolucion antes de un intercambio
+   * (si cambió) y al terminar; al empezar ws.mejorSolucion debe ser la actual.
+   */
+  template <class Intercambio>
+  void trayectoriaTabu(EspacioTrabajo &ws, Peso &mejorCostoGlobal, int maxIteraciones, int tenureBase, Generador &gen,
+                       ControlBusqueda &control, int periodo, Intercambio intercambio)
+  {
+      EvaluadorIncremental &ev = ws.ev;
+      AsignacionCompacta &mejorSolucionGlobal = ws.mejorSolucion;
+      int n = ev.numVariables();
+      RastroMejor &rastro = ws.rastro;
+      rastro.reiniciar(n);
+      bool pendienteMaterializar = false;
+      const int variacionTenure = 5;
+      // 1. Estructura de Lista Tabú: almacena la iteración hasta la cual la variable está prohibida
+      vector<int> &tabuUntil = ws.tabuHasta;
+      tabuUntil.assign(n, 0);
+      uniform_int_distribution<> disTenure(0, variacionTenure); // Variación de tenure
+
+      int tamAnillo = tenureBase + variacionTenure + 2;
+      vector<vector<int>> &vencimientos = ws.vencimientos;
+      if ((int)vencimientos.size() < tamAnillo)
+          vencimientos.resize(tamAnillo);
+      MonticuloMovimientos &libres = ws.monticulos[0], &tabues = ws.monticulos[1];
+      auto reconstruir = [&]()
+      {
+          libres.inicializar(n);
+          tabues.inicializar(n);
+          for (int i = 0; i < n; i++)
+              libres.insertar(i, ev.delta(i));
+          for (int b = 0; b < tamAnillo; b++)
+              vencimientos[b].clear();
+          fill(tabuUntil.begin(), tabuUntil.end(), 0);
+      };
+      reconstruir();
+      ev.activarRegistroCambios();
+
+      PasosLocales pasos(control);
+      for (int iter = 1; iter <= maxIteraciones && pasos.continuar(); iter++) 
+      {
+          // Las variables cuyo tenure vence en esta iteración vuelven a estar libres
+          vector<int> &cubeta = vencimientos[iter % tamAnillo];
+          for (int v : cubeta)
+          {
+              if (tabuUntil[v] == iter && tabues.contiene(v))
+              {
+                  tabues.quitar(v);
+                  libres.insertar(v, ev.delta(v));
+              }
+          }
+          cubeta.clear();
+
+          // 2-3. Mejor libre o, por aspiración, mejor tabú que supere al mejor global
+          Peso costoActual = ev.getCosto();
+          int mejorVarIdx = libres.vacio() ? -1 : libres.tope();
+          if (!tabues.vacio())
+          {
+              int t = tabues.tope();
+              bool aspira = (costoActual + tabues.getClave(t) < mejorCostoGlobal);
+              if (aspira && (mejorVarIdx == -1 || tabues.getClave(t) < libres.getClave(mejorVarIdx) ||
+                             (tabues.getClave(t) == libres.getClave(mejorVarIdx) && t < mejorVarIdx)))
+                  mejorVarIdx = t;
+          }
+
+          // 4. Ejecutar el mejor movimiento encontrado (aunque sea peor que el actual)
+          if (mejorVarIdx != -1) 
+          {
+              ev.flip(mejorVarIdx);
+              rastro.registrar(mejorVarIdx);
+              for (int u : ev.getCambiados())
+                  (libres.contiene(u) ? libres : tabues).actualizar(u, ev.delta(u));
+              ev.limpiarCambios();
+              
+              // Actualizar lista tabú con tenure variable
+              tabuUntil[mejorVarIdx] = iter + tenureBase + disTenure(gen);
+              if (tabuUntil[mejorVarIdx] > iter + 1)
+              {
+                  if (libres.contiene(mejorVarIdx))
+                  {
+                      libres.quitar(mejorVarIdx);
+                      tabues.insertar(mejorVarIdx, ev.delta(mejorVarIdx));
+                  }
+                  vencimientos[tabuUntil[mejorVarIdx] % tamAnillo].push_back(mejorVarIdx);
+              }
+              else if (tabues.contiene(mejorVarIdx))
+              {
+                  // Tenure <= 1 tras una aspiración: su vencimiento anterior ya no
+                  // coincide con tabuUntil, así que nadie la liberaría
+                  tabues.quitar(mejorVarIdx);
+                  libres.insertar(mejorVarIdx, ev.delta(mejorVarIdx));
+              }
+
+              // Actualizar mejor global si aplica
+              if (ev.getCosto() < mejorCostoGlobal) 
+              {
+                  mejorCostoGlobal = ev.getCosto();
+                  rastro.marcarMejor();
+                  pendienteMaterializar = true;
+                  pasos.reportar(mejorCostoGlobal);
+              }
+          }
+
+          if (periodo > 0 && iter % periodo == 0)
+          {
+              if (pendienteMaterializar)
+                  rastro.materializar(ev.getAsignacionCompacta(), mejorSolucionGlobal);
+              pendienteMaterializar = false;
+              if (intercambio(ev, mejorCostoGlobal, mejorSolucionGlobal))
+              {
+                  // El punto actual es la élite recibida, que pasa a ser la mejor
+                  rastro.reiniciar(n);
+                  reconstruir();
+                  ev.activarRegistroCambios();
+              }
+          }
+      }
+      // El espacio vuelve al pool: el siguiente método no debe pagar el registro
+      ev.desactivarRegistroCambios();
+      if (pendienteMaterializar)
+          rastro.materializar(ev.getAsignacionCompacta(), mejorSolucionGlobal);
+  }
+
+  // El generador solo sortea la parte variable del tenure
+  void busquedaTabu(vector<TBool> &vars, int maxIteraciones, int tenureBase, Generador &gen, EspacioTrabajo &ws,
+                    ControlBusqueda &control) 
+  {
+      ws.ev.inicializar(vars);
+      ws.mejorSolucion = ws.ev.getAsignacionCompacta();
+      Peso mejorCostoGlobal = ws.ev.getCosto();
+      control.reportar(mejorCostoGlobal);
+
+      trayectoriaTabu(ws, mejorCostoGlobal, maxIteraciones, tenureBase, gen, control, 0,
+                      [](EvaluadorIncremental &, Peso &, AsignacionCompacta &) { return false; });
+      // Retornar la mejor solución encontrada en todo el proceso
+      ws.mejorSolucion.desempaquetar(vars);
+  }
+
+  /**
+   * Tabú cooperativa: numTrabajadores trayectorias (tareas OpenMP) con tenure
+   * diversificado entre 0.5 y 1.5 veces tenureBase. Cada periodo iteraciones un
+   * trabajador publica su mejor solución en el pool de élite y, si no mejoró en
+   * el último periodo, salta a una élite mejor que la suya. El ciclo de
+   * iteración no toca el pool: solo se accede a él en los cambios de periodo,
+   * con las operaciones atómicas de shared_ptr. Cada trabajador toma su propio
+   * espacio de trabajo.
+   */
+  void busquedaTabuCooperativa(vector<TBool> &vars, int maxIteraciones, int tenureBase, int numTrabajadores,
+                               int periodo, Generador &gen, ControlBusqueda &control)
+  {
+      PoolElite pool(max(2, numTrabajadores));
+      AsignacionCompacta inicial(vars);
+      pool.publicar(calcularCosto(inicial), inicial);
+      control.reportar(pool.mejor()->costo);
+
+      vector<uint64_t> semillas(numTrabajadores);
+      for (uint64_t &semilla : semillas)
+          semilla = gen();
+
+#pragma omp taskloop grainsize(1) default(shared)
+      for (int w = 0; w < numTrabajadores; w++)
+      {
+          Generador genTrabajador(semillas[w]);
+          double factor = numTrabajadores > 1 ? 0.5 + (double)w / (numTrabajadores - 1) : 1.0;
+          int tenure = max(1, (int)(tenureBase * factor));
+
+          auto espacio = prestarEspacio();
+          EspacioTrabajo &ws = *espacio;
+          Contadores antes = ws.ev.getContadores();
+          ws.ev.inicializar(inicial);
+          ws.mejorSolucion = inicial;
+          Peso mejorCosto = ws.ev.getCosto();
+          Peso costoPublicado = mejorCosto;
+          Peso costoPeriodoAnterior = mejorCosto;
+
+          trayectoriaTabu(ws, mejorCosto, maxIteraciones, tenure, genTrabajador, control, periodo,
+                          [&](EvaluadorIncremental &e, Peso &costo, AsignacionCompacta &mejor)
+                          {
+                              bool salto = false;
+                              if (costo < costoPublicado)
+                              {
+                                  pool.publicar(costo, mejor);
+                                  costoPublicado = costo;
+                              }
+                              if (costo >= costoPeriodoAnterior)
+                              {
+                                  auto elite = pool.elegir(genTrabajador);
+                                  if (elite && elite->costo < costo)
+                                  {
+                                      e.inicializar(elite->vars);
+                                      costo = elite->costo;
+                                      mejor = elite->vars;
+                                      costoPublicado = costo;
+                                      salto = true;
+                                  }
+                              }
+                              costoPeriodoAnterior = costo;
+                              return salto;
+                          });
+          if (mejorCosto < costoPublicado)
+              pool.publicar(mejorCosto, ws.mejorSolucion);
+          control.acumular(ws.ev.getContadores() - antes);
+      }
+
+      pool.mejor()->vars.desempaquetar(vars);
+  }
+
+  /**
+   * Recocido simulado 1-flip sobre deltas incrementales. Al empezar cada nivel
+   * de temperatura se tabula e^(-delta / T) para los deltas enteros pequeños;
+   * los demás se calculan al vuelo. La mejor solución no se copia en cada
+   * mejora: se sigue con el RastroMejor del espacio de trabajo y se
+   * materializa una sola vez, al terminar.
+   *
+   * Con enfriamiento adaptativo el factor de cada nivel depende de la tasa de
+   * aceptación de movimientos peores frente a parametros.tasaObjetivo; con
+   * nivelesSinMejora > 0 la temperatura se recalienta tras ese número de
+   * niveles sin mejorar el mejor global (como mucho maxRecalentamientos veces).
+   * Con un presupuesto de flips o de tiempo el factor de cada nivel no es
+   * alpha sino el que lleva T a tempMinima justo al agotarlo, estimado con lo
+   * que gastó el último nivel (el esquema fijo, unos 34k flips, quedaría
+   * cortado en caliente con presupuestos cortos); el ajuste adaptativo y los
+   * recalentamientos actúan sobre ese factor. Si igual se enfría antes (o el
+   * único límite es maxSinMejora), vuelve a empezar desde tempInicial.
+   */
+  void recocidoSimulado(vector<TBool> &vars, Generador &gen, EspacioTrabajo &ws, const ParametrosSA &parametros,
+                        ControlBusqueda &control)
+  {
+      int n = vars.size();
+      EvaluadorIncremental &ev = ws.ev;
+      ev.inicializar(vars);
+      RastroMejor &rastro = ws.rastro;
+      rastro.reiniciar(n);
+      
+      Peso mejorCostoGlobal = ev.getCosto();
+      control.reportar(mejorCostoGlobal);
+      
+      double T = parametros.tempInicial;
+
+      // Distribuciones para aleatoriedad
+      uniform_int_distribution<> varDist(0, n - 1);
+      uniform_real_distribution<> probDist(0.0, 1.0);
+
+      const int TAM_TABLA = 64;
+      double aceptacion[TAM_TABLA];
+      int nivelesSinMejora = 0, recalentamientos = 0;
+      double progresoNivel = control.progreso();
+      bool porPresupuesto = progresoNivel >= 0;
+
+      PasosLocales pasos(control);
+      while (!control.agotado())
+      {
+          if (T <= parametros.tempMinima)
+          {
+              if (!control.limitado() || !control.continuar(0))
+                  break;
+              T = parametros.tempInicial;
+              recalentamientos = 0;
+          }
+
+          for (int d = 0; d < TAM_TABLA; d++)
+              aceptacion[d] = exp(-(double)d / T);
+          bool mejoroNivel = false;
+          int peoresPropuestos = 0, peoresAceptados = 0;
+
+          for (int i = 0; i < parametros.iterPorTemp && pasos.continuar(); i++) 
+          {
+              // 1. Elegir un vecino aleatorio (1-flip)
+              int idx = varDist(gen);
+              Peso delta = ev.delta(idx); // delta < 0 es una mejora
+
+              // 2. Criterio de aceptación (Metrópolis)
+              if (delta < 0) 
+              {
+                  // Mejora directa
+                  ev.flip(idx);
+                  rastro.registrar(idx);
+                  if (ev.getCosto() < mejorCostoGlobal) 
+                  {
+                      mejorCostoGlobal = ev.getCosto();
+                      rastro.marcarMejor();
+                      mejoroNivel = true;
+                      pasos.reportar(mejorCostoGlobal);
+                  }
+              } 
+              else 
+              {
+                  // Movimiento peor: se acepta con probabilidad e^(-delta / T)
+                  double probabilidad = delta < TAM_TABLA ? aceptacion[delta] : exp(-(double)delta / T);
+                  peoresPropuestos += delta > 0;
+                  if (probDist(gen) < probabilidad) 
+                  {
+                      ev.flip(idx);
+                      rastro.registrar(idx);
+                      peoresAceptados += delta > 0;
+                  }
+              }
+          }
+
+          nivelesSinMejora = mejoroNivel ? 0 : nivelesSinMejora + 1;
+
+          // 3. Enfriamiento
+          double factor = parametros.alpha;
+          if (porPresupuesto)
+          {
+              // Niveles que faltan al ritmo del último, y el factor que llega a tempMinima en ellos
+              double p = control.progreso();
+              double avance = p - progresoNivel;
+              progresoNivel = p;
+              if (avance > 0 && p < 1)
+                  factor = pow(parametros.tempMinima / T, 1.0 / max(1.0, (1 - p) / avance));
+          }
+          if (parametros.enfriamiento == EnfriamientoSA::Adaptativo && peoresPropuestos > 0)
+          {
+              double tasa = (double)peoresAceptados / peoresPropuestos;
+              if (tasa > parametros.tasaObjetivo)
+                  factor = factor * factor; // acepta de más: enfriar más rápido
+              else if (tasa < parametros.tasaObjetivo / 2)
+                  factor = sqrt(factor); // casi congelado: enfriar más lento
+          }
+          T *= factor;
+
+          if (parametros.nivelesSinMejora > 0 && nivelesSinMejora >= parametros.nivelesSinMejora &&
+              recalentamientos < parametros.maxRecalentamientos)
+          {
+              T = max(T, parametros.factorRecalentamiento * parametros.tempInicial);
+              nivelesSinMejora = 0;
+              recalentamientos++;
+          }
+      }
+      rastro.materializar(ev.getAsignacionCompacta(), ws.mejorSolucion);
+      ws.mejorSolucion.desempaquetar(vars);
+  }
+
+  /**
+   * Fase de Construcción de GRASP: Greedy Randomized
+   * El beneficio de una variable es max(pos, neg) sobre las cláusulas aún
+   * abiertas; se descuenta a medida que se deciden, igual que en
+   * solverConstructivo. Dos montículos dan S_max y S_min en O(1) y la RCL se
+   * obtiene recorriendo solo la parte del montículo de máximos sobre el umbral.
+   * Si la RCL es grande (muchos empates) se muestrea por rechazo entre las
+   * variables pendientes, que acierta con probabilidad |RCL| / pendientes.
+   * @param alpha Parámetro entre 0 y 1. 
+   * 0 = Totalmente Greedy, 1 = Totalmente Aleatorio.
+   */
+  void construccionGRASP(vector<TBool> &vars, const vector<Conteo> &frecsIniciales, double alpha, Generador &gen,
+                         EspacioTrabajo &ws) 
+  {
+      int n = vars.size();
+      vector<Conteo> &frecs = ws.frecs;
+      frecs.assign(frecsIniciales.begin(), frecsIniciales.end());
+      vector<TBool> &estado = ws.estadoClausulas;
+      estado.assign(formula.numClausulas(), TBool::Unknown);
+      auto beneficio = [&frecs](int v) { return max(frecs[v].pos, frecs[v].neg); };
+
+      MonticuloMovimientos &porMaximo = ws.monticulos[0], &porMinimo = ws.monticulos[1];
+      porMaximo.inicializar(n);
+      porMinimo.inicializar(n);
+      vector<int> &pendientes = ws.pendientes, &posPendiente = ws.posPendiente;
+      pendientes.clear();
+      posPendiente.assign(n, -1);
+      for (int v = 0; v < n; v++) {
+          if (vars[v] == TBool::Unknown) {
+              porMaximo.insertar(v, -beneficio(v));
+              porMinimo.insertar(v, beneficio(v));
+              posPendiente[v] = pendientes.size();
+              pendientes.push_back(v);
+          }
+      }
+
+      const size_t MAX_RCL_EXPLICITA = 256;
+      vector<int> &rcl = ws.rcl;
+      while (!porMaximo.vacio()) 
+      {
+          // 1. Encontrar el rango de beneficio (S_min y S_max)
+          Peso s_max = -porMaximo.getClave(porMaximo.tope());
+          Peso s_min = porMinimo.getClave(porMinimo.tope());
+
+          // Sin cláusulas abiertas el orden ya no importa: el resto toma su polaridad
+          if (s_max <= 0)
+              break;
+
+          // 2. Definir el umbral para la RCL (Lista Restringida de Candidatos)
+          // Umbral = S_max - alpha * (S_max - S_min)
+          double umbral = s_max - alpha * (s_max - s_min);
+          
+          rcl.clear();
+          bool completa = porMaximo.recorrerHasta(-umbral, [&rcl, MAX_RCL_EXPLICITA](int v)
+                                                 {
+                                                     rcl.push_back(v);
+                                                     return rcl.size() <= MAX_RCL_EXPLICITA;
+                                                 });
+
+          // 3. Selección aleatoria de la RCL
+          int idElegido;
+          if (completa) {
+              uniform_int_distribution<> dis(0, rcl.size() - 1);
+              idElegido = rcl[dis(gen)];
+          } else {
+              uniform_int_distribution<> dis(0, pendientes.size() - 1);
+              do {
+                  idElegido = pendientes[dis(gen)];
+              } while (beneficio(idElegido) < umbral);
+          }
+          
+          // Asignar y actualizar (similar a tu solverConstructivo)
+          bool valor = frecs[idElegido].pos >= frecs[idElegido].neg;
+          vars[idElegido] = valor ? TBool::True : TBool::False;
+          porMaximo.quitar(idElegido);
+          porMinimo.quitar(idElegido);
+          int ultima = pendientes.back();
+          pendientes[posPendiente[idElegido]] = ultima;
+          posPendiente[ultima] = posPendiente[idElegido];
+          pendientes.pop_back();
+
+          propagarAsignacion(idElegido, estado, vars, frecs, [&](int u)
+                             {
+                               if (porMaximo.contiene(u)) {
+                                   porMaximo.actualizar(u, -beneficio(u));
+                                   porMinimo.actualizar(u, beneficio(u));
+                               }
+                             });
+      }
+
+      for (int v = 0; v < n; v++)
+          if (vars[v] == TBool::Unknown)
+              vars[v] = frecs[v].pos >= frecs[v].neg ? TBool::True : TBool::False;
+  }
+
+  /**
+   * Path relinking desde la solución de ws.ev hacia guia: en cada paso se
+   * invierte, entre las variables en que aún difieren, la de menor delta (a
+   * igualdad, la de menor índice). Las candidatas viven en un montículo por
+   * delta en el que solo se actualizan las variables cuyo delta cambió con el
+   * flip, así que el camino cuesta O(d log n) más las ocurrencias de las d
+   * variables invertidas, en lugar de O(d²).
+   * Deja en ws.ev la mejor solución estrictamente intermedia del camino y
+   * devuelve false si no hay ninguna (las soluciones difieren en menos de 2).
+   */
+  bool reenlazar(EspacioTrabajo &ws, const vector<TBool> &guia, ControlBusqueda &control)
+  {
+    EvaluadorIncremental &ev = ws.ev;
+    int n = ev.numVariables();
+    MonticuloMovimientos &candidatas = ws.monticulos[0];
+    candidatas.inicializar(n);
+    const vector<TBool> &actual = ev.getAsignacion();
+    int diferencia = 0;
+    for (int v = 0; v < n; v++)
+      if (actual[v] != guia[v])
+      {
+        candidatas.insertar(v, ev.delta(v));
+        diferencia++;
+      }
+    if (diferencia < 2)
+      return false;
+
+    RastroMejor &rastro = ws.rastro;
+    rastro.reiniciar(n);
+    ev.seguirFlips(&rastro);
+    ev.activarRegistroCambios();
+    Peso mejorCosto = numeric_limits<Peso>::max();
+    PasosLocales pasos(control);
+    for (int paso = 1; paso < diferencia && pasos.continuar(); paso++)
+    {
+      int v = candidatas.tope();
+      candidatas.quitar(v);
+      ev.flip(v);
+      for (int u : ev.getCambiados())
+        if (candidatas.contiene(u))
+          candidatas.actualizar(u, ev.delta(u));
+      ev.limpiarCambios();
+      if (ev.getCosto() < mejorCosto)
+      {
+        mejorCosto = ev.getCosto();
+        rastro.marcarMejor();
+      }
+    }
+    ev.desactivarRegistroCambios();
+    ev.seguirFlips(nullptr);
+    rastro.volverAlMejor(ev);
+    return mejorCosto != numeric_limits<Peso>::max();
+  }
+
+  /**
+   * GRASP multiarranque. Los arranques son independientes y se reparten como
+   * tareas OpenMP entre los hilos libres; cada uno usa su propia semilla (tomada
+   * de gen en orden), así que el resultado no depende del reparto entre hilos.
+   * Los hilos comparten el mejor costo y dejan de arrancar al llegar a 0.
+   * Cada arranque trabaja en un espacio de trabajo prestado del pool. Con un
+   * presupuesto limitado se repiten rondas de maxIteraciones arranques hasta
+   * agotarlo; el primer arranque siempre se completa.
+   *
+   * Los arranques alimentan un conjunto élite de hasta TAM_ELITE soluciones
+   * distintas, ordenado por (costo, arranque). Al terminar se reenlaza la mejor
+   * con cada una de las demás y se mejora con búsqueda local el mejor punto de
+   * cada camino.
+   */
+  void busquedaGRASP(vector<TBool> &vars, int maxIteraciones, double alpha, Generador &gen, const vector<Conteo>& frecsOriginales,
+                     ControlBusqueda &control) 
+  {
+      MejorConocido mejorGlobal;
+      vector<TBool> mejorSolucionGlobal;
+      Peso costoGuardado = numeric_limits<Peso>::max();
+      long long arranqueGuardado = numeric_limits<long long>::max();
+      mutex mtxMejor;
+      vector<uint64_t> semillas(maxIteraciones);
+
+      struct Elite
+      {
+        Peso costo;
+        long long arranque;
+        vector<TBool> solucion;
+        bool operator<(const Elite &o) const { return costo < o.costo || (costo == o.costo && arranque < o.arranque); }
+      };
+      const size_t TAM_ELITE = 5;
+      vector<Elite> elite;
+      mutex mtxElite;
+      // Una solución repetida se queda con el menor arranque, así que el
+      // conjunto final no depende del orden en que terminan las tareas
+      auto proponerElite = [&](Peso costo, long long arranque, const vector<TBool> &solucion)
+      {
+        lock_guard<mutex> lock(mtxElite);
+        Elite candidato{costo, arranque, {}};
+        if (elite.size() == TAM_ELITE && !(candidato < elite.back()))
+          return;
+        for (Elite &e : elite)
+          if (e.costo == costo && e.solucion == solucion)
+          {
+            e.arranque = min(e.arranque, arranque);
+            sort(elite.begin(), elite.end());
+            return;
+          }
+        candidato.solucion = solucion;
+        elite.insert(upper_bound(elite.begin(), elite.end(), candidato), move(candidato));
+        if (elite.size() > TAM_ELITE)
+          elite.pop_back();
+      };
+
+      for (long long ronda = 0; ronda == 0 || (control.limitado() && mejorGlobal.get() > 0 && control.continuar(0)); ronda++)
+      {
+          for (uint64_t &semilla : semillas)
+              semilla = gen();
+
+#pragma omp taskloop grainsize(1) default(shared)
+          for (int i = 0; i < maxIteraciones; i++) 
+          {
+              long long arranque = ronda * maxIteraciones + i;
+              if (mejorGlobal.get() == 0 || (arranque > 0 && !control.continuar(0)))
+                  continue;
+
+              Generador genArranque(semillas[i]);
+              auto espacio = prestarEspacio();
+              EspacioTrabajo &ws = *espacio;
+              Contadores antes = ws.ev.getContadores();
+              vector<TBool> &actual = ws.asignacion;
+              actual.assign(vars.size(), TBool::Unknown);
+              // La fase constructiva trabaja sobre una copia de las frecuencias en ws
+              construccionGRASP(actual, frecsOriginales, alpha, genArranque, ws); 
+              control.continuar(actual.size()); // la construcción cuenta un paso por variable
+              ws.ev.inicializar(actual);
+              control.reportar(ws.ev.getCosto());
+              pasoBusquedaLocal(ws, genArranque, control);
+          
+              Peso costoFinal = ws.ev.getCosto();
+              mejorGlobal.actualizar(costoFinal);
+              proponerElite(costoFinal, arranque, ws.ev.getAsignacion());
+              if (costoFinal <= mejorGlobal.get()) {
+                  // Empates: gana el arranque de menor índice, como en la versión secuencial
+                  lock_guard<mutex> lock(mtxMejor);
+                  if (costoFinal < costoGuardado || (costoFinal == costoGuardado && arranque < arranqueGuardado)) {
+                      costoGuardado = costoFinal;
+                      arranqueGuardado = arranque;
+                      mejorSolucionGlobal = ws.ev.getAsignacion();
+                  }
+              }
+              control.acumular(ws.ev.getContadores() - antes);
+          }
+      }
+
+      // Path relinking entre la mejor solución élite y cada una de las demás
+      int caminos = mejorGlobal.get() > 0 && control.continuar(0) ? (int)elite.size() - 1 : 0;
+      vector<Peso> costosCamino(max(caminos, 0), numeric_limits<Peso>::max());
+      vector<vector<TBool>> solucionesCamino(costosCamino.size());
+#pragma omp taskloop grainsize(1) default(shared)
+      for (int j = 0; j < caminos; j++)
+      {
+          if (mejorGlobal.get() == 0 || !control.continuar(0))
+              continue;
+          auto espacio = prestarEspacio();
+          EspacioTrabajo &ws = *espacio;
+          Contadores antes = ws.ev.getContadores();
+          Generador genCamino(derivarSemilla(semillas[0], j + 1));
+          ws.ev.inicializar(elite[0].solucion);
+          if (reenlazar(ws, elite[j + 1].solucion, control))
+          {
+              control.reportar(ws.ev.getCosto());
+              pasoBusquedaLocal(ws, genCamino, control);
+              costosCamino[j] = ws.ev.getCosto();
+              solucionesCamino[j] = ws.ev.getAsignacion();
+              mejorGlobal.actualizar(costosCamino[j]);
+          }
+          control.acumular(ws.ev.getContadores() - antes);
+      }
+      for (int j = 0; j < caminos; j++)
+          if (costosCamino[j] < costoGuardado) {
+              costoGuardado = costosCamino[j];
+              mejorSolucionGlobal = move(solucionesCamino[j]);
+          }
+      vars = mejorSolucionGlobal;
+  }
+};
+
+/**
+ * Archivo de solo lectura proyectado en memoria con mmap. Si la proyección no
+ * es posible (p. ej. una tubería) se lee completo a un buffer propio.
+ */
+class ArchivoMapeado
+{
+private:
+  const char *datos = nullptr;
+  size_t tamano = 0;
+  bool mapeado = false;
+  vector<char> respaldo;
+
+public:
+  ArchivoMapeado() {}
+  ArchivoMapeado(const ArchivoMapeado &) = delete;
+  ArchivoMapeado &operator=(const ArchivoMapeado &) = delete;
+  ~ArchivoMapeado()
+  {
+    if (mapeado)
+      munmap((void *)datos, tamano);
+  }
+
+  bool abrir(const string &nombreArchivo)
+  {
+    int fd = open(nombreArchivo.c_str(), O_RDONLY);
+    if (fd < 0)
+      return false;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+    {
+      void *p = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p != MAP_FAILED)
+      {
+        madvise(p, info.st_size, MADV_SEQUENTIAL);
+        datos = (const char *)p;
+        tamano = info.st_size;
+        mapeado = true;
+        close(fd);
+        return true;
+      }
+    }
+
+    char bloque[1 << 16];
+    ssize_t leidos;
+    while ((leidos = read(fd, bloque, sizeof(bloque))) > 0)
+      respaldo.insert(respaldo.end(), bloque, bloque + leidos);
+    close(fd);
+    datos = respaldo.data();
+    tamano = respaldo.size();
+    return true;
+  }
+
+  const char *inicio() const { return datos; }
+  const char *fin() const { return datos + tamano; }
+  size_t getTamano() const { return tamano; }
+};
+
+/**
+ * Lector de enteros DIMACS directamente sobre el buffer del archivo, sin
+ * strings ni streams por línea.
+ */
+class EscanerDimacs
+{
+private:
+  const char *p;
+  const char *fin;
+
+  static bool esBlanco(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+public:
+  EscanerDimacs(const char *ini, const char *f) : p(ini), fin(f) {}
+
+  // Salta espacios y saltos de línea; false al llegar al final
+  bool saltarBlancos()
+  {
+    while (p < fin && esBlanco(*p))
+      p++;
+    return p < fin;
+  }
+
+  void saltarLinea()
+  {
+    const char *salto = (const char *)memchr(p, '\n', fin - p);
+    p = salto ? salto + 1 : fin;
+  }
+
+  bool lineaContiene(const char *texto) const
+  {
+    const char *salto = (const char *)memchr(p, '\n', fin - p);
+    const char *finLinea = salto ? salto : fin;
+    return memmem(p, finLinea - p, texto, strlen(texto)) != nullptr;
+  }
+
+  char actual() const { return *p; }
+  void avanzar() { p++; }
+
+  string palabra()
+  {
+    while (p < fin && (*p == ' ' || *p == '\t'))
+      p++;
+    const char *ini = p;
+    while (p < fin && !esBlanco(*p))
+      p++;
+    return string(ini, p);
+  }
+
+  // Lee el siguiente entero; si soloEnLinea, no cruza el salto de línea
+  bool leerEntero(long long &valor, bool soloEnLinea = false)
+  {
+    if (soloEnLinea)
+      while (p < fin && (*p == ' ' || *p == '\t' || *p == '\r'))
+        p++;
+    else
+      saltarBlancos();
+
+    bool negativo = false;
+    if (p < fin && *p == '-')
+    {
+      negativo = true;
+      p++;
+    }
+    if (p >= fin || *p < '0' || *p > '9')
+      return false;
+
+    long long x = 0;
+    while (p < fin && *p >= '0' && *p <= '9')
+      x = x * 10 + (*p++ - '0');
+    valor = negativo ? -x : x;
+    return true;
+  }
+};
+
+// Pico de memoria residente del proceso (ru_maxrss está en KB en Linux)
+double picoMemoriaMB()
+{
+  struct rusage uso;
+  return getrusage(RUSAGE_SELF, &uso) == 0 ? uso.ru_maxrss / 1024.0 : 0.0;
+}
+
+struct EstadisticasCarga
+{
+  size_t bytes = 0;
+  double segundos = 0.0;
+  bool desdeCache = false;
+  uint64_t hashFuente = 0; // solo con el caché activado
+  double mbPorSegundo() const { return segundos > 0 ? bytes / (1024.0 * 1024.0) / segundos : 0.0; }
+};
+
+/**
+ * Parser DIMACS incremental: procesar() recibe tramos consecutivos del archivo,
+ * cada uno terminado en un salto de línea, y una cláusula puede seguir en el
+ * tramo siguiente (solo el 0 la cierra). Así el mismo parser sirve para el
+ * archivo proyectado completo y para la lectura por bloques.
+ *
+ * Acepta "p cnf", "p wcnf n m [top]" y el formato sin preámbulo de MaxSAT
+ * Evaluation (siempre con pesos, "h" = dura). Las instancias "Standarized
+ * MaxSat" traen "p cnf" pero con un peso al inicio de cada cláusula; se
+ * detectan por los metadatos "nhards" en los comentarios. En WCNF clásico las
+ * cláusulas con peso >= top son duras.
+ */
+class ParserDimacs
+{
+private:
+  FormulaCompacta &formula;
+  size_t tamanoFuente;
+  bool conPeso = true; // Sin preámbulo: formato nuevo
+  bool hayPreambulo = false;
+  bool metadatosMaxSat = false;
+  bool terminado = false;
+  Peso top = 0;
+
+  // Cláusula en curso (sus literales pueden ocupar varias líneas)
+  bool enClausula = false;
+  Peso peso = 1;
+  bool esDura = false;
+  vector<int> clausula;
+
+  void cerrarClausula()
+  {
+    formula.agregarClausula(clausula, peso, esDura);
+    clausula.clear();
+    enClausula = false;
+  }
+
+public:
+  ParserDimacs(FormulaCompacta &f, size_t tamano) : formula(f), tamanoFuente(tamano) {}
+
+  void procesar(const char *ini, const char *fin)
+  {
+    EscanerDimacs esc(ini, fin);
+    long long valor = 0;
+
+    while (!terminado && esc.saltarBlancos())
+    {
+      if (enClausula)
+      {
+        bool leido;
+        while ((leido = esc.leerEntero(valor)) && valor != 0)
+          clausula.push_back(valor);
+        // Al final del tramo la cláusula sigue abierta; una línea no numérica la cierra
+        if (leido || esc.saltarBlancos())
+          cerrarClausula();
+        continue;
+      }
+
+      char c0 = esc.actual();
+      if (c0 == 'c')
+      {
+        if (!hayPreambulo && esc.lineaContiene("\"nhards\""))
+          metadatosMaxSat = true;
+        esc.saltarLinea();
+        continue;
+      }
+      if (c0 == '%') // Fin de datos en las instancias de SATLIB
+      {
+        terminado = true;
+        break;
+      }
+      if (c0 == 'p')
+      {
+        esc.avanzar();
+        string formato = esc.palabra();
+        long long nVars = 0, nClausulas = 0;
+        esc.leerEntero(nVars, true);
+        esc.leerEntero(nClausulas, true);
+        top = esc.leerEntero(valor, true) ? valor : 0;
+        esc.saltarLinea();
+
+        hayPreambulo = true;
+        conPeso = formato == "wcnf" || metadatosMaxSat;
+        formula = FormulaCompacta(nVars);
+        // ~4 bytes por literal en los archivos de prueba; evita realocar el arreglo plano
+        formula.reservar(nClausulas, max<size_t>(3 * nClausulas, tamanoFuente / 4));
+        continue;
+      }
+
+      peso = 1;
+      esDura = false;
+      if (c0 == 'h')
+      {
+        esc.avanzar();
+        esDura = true;
+      }
+      else if (c0 != '-' && (c0 < '0' || c0 > '9'))
+      {
+        esc.saltarLinea(); // Línea no reconocida
+        continue;
+      }
+      else if (conPeso)
+      {
+        esc.leerEntero(valor);
+        peso = valor;
+        esDura = (top > 0 && peso >= top);
+      }
+      enClausula = true;
+    }
+  }
+
+  // Cierra la última cláusula si el archivo termina sin su 0 y finaliza la fórmula
+  void terminar()
+  {
+    if (enClausula)
+      cerrarClausula();
+    formula.finalizar();
+  }
+};
+
+void parsearDimacs(const ArchivoMapeado &archivo, FormulaCompacta &formula)
+{
+  ParserDimacs parser(formula, archivo.getTamano());
+  parser.procesar(archivo.inicio(), archivo.fin());
+  parser.terminar();
+}
+
+const size_t BLOQUE_LECTURA = 1 << 20;
+
+/**
+ * Lee fd hasta el final en bloques de BLOQUE_LECTURA bytes y pasa a procesar
+ * tramos que terminan en un salto de línea; el resto de la última línea pasa
+ * al bloque siguiente (el buffer crece si una línea no cabe). Devuelve los
+ * bytes leídos, o -1 si falla la lectura.
+ */
+template <class Procesar>
+long long leerPorBloques(int fd, Procesar procesar)
+{
+  vector<char> buffer(BLOQUE_LECTURA);
+  size_t arrastre = 0;
+  long long total = 0;
+  while (true)
+  {
+    if (arrastre == buffer.size())
+      buffer.resize(2 * buffer.size());
+    ssize_t leidos = read(fd, buffer.data() + arrastre, buffer.size() - arrastre);
+    if (leidos < 0 && errno == EINTR)
+      continue;
+    if (leidos < 0)
+      return -1;
+    if (leidos == 0)
+      break;
+    total += leidos;
+
+    size_t lleno = arrastre + leidos;
+    const char *salto = (const char *)memrchr(buffer.data(), '\n', lleno);
+    size_t corte = salto ? salto - buffer.data() + 1 : 0;
+    if (corte > 0)
+      procesar(buffer.data(), buffer.data() + corte);
+    memmove(buffer.data(), buffer.data() + corte, lleno - corte);
+    arrastre = lleno - corte;
+  }
+  if (arrastre > 0)
+    procesar(buffer.data(), buffer.data() + arrastre);
+  return total;
+}
+
+/**
+ * Hash de 64 bits del contenido (8 bytes por paso), clave del caché binario.
+ * Se calcula por tramos de cualquier tamaño: con el tamaño total declarado de
+ * entrada, el resultado es el mismo que sobre el contenido completo.
+ */
+class HashContenido
+{
+private:
+  uint64_t h;
+  char resto[8];
+  size_t numResto = 0;
+
+  void mezclar(const char *palabra)
+  {
+    uint64_t x;
+    memcpy(&x, palabra, 8);
+    h = (h ^ x) * 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 32;
+  }
+
+public:
+  explicit HashContenido(size_t tamano) : h(0x9E3779B97F4A7C15ULL ^ tamano) {}
+
+  void agregar(const char *datos, size_t tamano)
+  {
+    size_t i = 0;
+    while (numResto > 0 && i < tamano)
+    {
+      resto[numResto++] = datos[i++];
+      if (numResto == 8)
+      {
+        mezclar(resto);
+        numResto = 0;
+      }
+    }
+    for (; i + 8 <= tamano; i += 8)
+      mezclar(datos + i);
+    for (; i < tamano; i++)
+      resto[numResto++] = datos[i];
+  }
+
+  uint64_t valor() const
+  {
+    uint64_t x = h;
+    for (size_t i = 0; i < numResto; i++)
+      x = (x ^ (unsigned char)resto[i]) * 0x100000001B3ULL;
+    return x ^ (x >> 29);
+  }
+};
+
+uint64_t hashContenido(const char *datos, size_t tamano)
+{
+  HashContenido h(tamano);
+  h.agregar(datos, tamano);
+  return h.valor();
+}
+
+/**
+ * Carga por bloques (--por-bloques): el texto nunca está entero en memoria, así
+ * que el pico queda cerca de los arreglos de la fórmula. Con el caché activado
+ * se hace una primera pasada solo para el hash.
+ */
+bool cargarPorBloques(const string &nombreArchivo, FormulaCompacta &formula, EstadisticasCarga &stats, bool usarCache)
+{
+  int fd = open(nombreArchivo.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat info;
+  bool regular = fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+  size_t tamano = regular ? info.st_size : 0;
+  posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+  // Sin un archivo regular no hay tamaño para el hash ni forma de releerlo
+  usarCache = usarCache && regular;
+  string nombreCache = nombreArchivo + "bin";
+  if (usarCache)
+  {
+    HashContenido h(tamano);
+    if (leerPorBloques(fd, [&h](const char *ini, const char *fin) { h.agregar(ini, fin - ini); }) < 0 ||
+        lseek(fd, 0, SEEK_SET) != 0)
+    {
+      close(fd);
+      return false;
+    }
+    stats.hashFuente = h.valor();
+    ArchivoMapeado binario;
+    stats.desdeCache = binario.abrir(nombreCache) &&
+                       formula.leerBinario(binario.inicio(), binario.getTamano(), stats.hashFuente, tamano);
+  }
+
+  long long leidos = tamano;
+  if (!stats.desdeCache)
+  {
+    ParserDimacs parser(formula, tamano);
+    leidos = leerPorBloques(fd, [&parser](const char *ini, const char *fin) { parser.procesar(ini, fin); });
+    if (leidos < 0)
+    {
+      close(fd);
+      return false;
+    }
+    parser.terminar();
+    if (usarCache && !formula.escribirBinario(nombreCache, stats.hashFuente, tamano))
+      cerr << "Aviso: no se pudo escribir el caché " << nombreCache << endl;
+  }
+  close(fd);
+  stats.bytes = leidos;
+  return true;
+}
+
+/**
+ * Carga el archivo, opcionalmente a través del caché binario <archivo>bin (p. ej.
+ * uf175-01.cnfbin). El caché se usa solo si su hash coincide con el del texto
+ * fuente; si no existe o está desactualizado se parsea el texto y se regenera.
+ */
+bool cargarFormula(const string &nombreArchivo, FormulaCompacta &formula, EstadisticasCarga *stats = nullptr, bool usarCache = false,
+                   bool porBloques = false)
+{
+  auto start = chrono::high_resolution_clock::now();
+  if (porBloques)
+  {
+    EstadisticasCarga propias;
+    EstadisticasCarga &st = stats ? *stats : propias;
+    if (!cargarPorBloques(nombreArchivo, formula, st, usarCache))
+      return false;
+    st.segundos = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+    return true;
+  }
+
+  ArchivoMapeado archivo;
+  if (!archivo.abrir(nombreArchivo))
+    return false;
+
+  bool desdeCache = false;
+  uint64_t hash = 0;
+  string nombreCache = nombreArchivo + "bin";
+  if (usarCache)
+  {
+    hash = hashContenido(archivo.inicio(), archivo.getTamano());
+    ArchivoMapeado binario;
+    desdeCache = binario.abrir(nombreCache) &&
+                 formula.leerBinario(binario.inicio(), binario.getTamano(), hash, archivo.getTamano());
+  }
+
+  if (!desdeCache)
+  {
+    parsearDimacs(archivo, formula);
+    if (usarCache && !formula.escribirBinario(nombreCache, hash, archivo.getTamano()))
+      cerr << "Aviso: no se pudo escribir el caché " << nombreCache << endl;
+  }
+
+  if (stats)
+  {
+    stats->bytes = archivo.getTamano();
+    stats->segundos = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+    stats->desdeCache = desdeCache;
+    stats->hashFuente = hash;
+  }
+  return true;
+}
+
+// Resultado del solver exacto: el óptimo si se demostró, si no una cota inferior
+struct ResultadoExacto
+{
+  bool demostrado = false;
+  Peso costo = 0;        // óptimo (demostrado) o mejor costo conocido
+  Peso cotaInferior = 0; // cota demostrada; igual a costo si demostrado
+  double segundos = 0;
+};
+
+/**
+ * Ramificación y acotamiento en profundidad sobre la FormulaCompacta. Cada
+ * cláusula lleva sus literales verdaderos y sin asignar, y el costo de las
+ * falsificadas se mantiene al asignar y desasignar. La cota de un nodo suma a
+ * ese costo, por cada variable libre, el menor peso entre las cláusulas que
+ * dependen solo de x y las que dependen solo de ¬x (una de las dos familias
+ * se pierde con cualquier valor, y las familias de variables distintas son
+ * disjuntas). La cota superior inicial es el mejor costo de las corridas: si el
+ * árbol se agota sin mejorarla, ese costo es el óptimo.
+ *
+ * Sin cláusulas vacías, una cota superior de 0 se demuestra en la raíz; así se
+ * cierran las uf175 satisfacibles. Si el presupuesto se agota, queda la cota
+ * de la raíz.
+ */
+class SolverExacto
+{
+private:
+  const FormulaCompacta &formula;
+  vector<TBool> valor;
+  vector<int> verdaderos, libres; // por cláusula
+  vector<Peso> unitarias;         // por literal: peso de las cláusulas abiertas que solo dependen de él
+  vector<Peso> binarias;          // por literal: peso de las cláusulas abiertas con él y otro libre
+  Peso costo = 0;
+
+  bool abierta(int c) const { return verdaderos[c] == 0 && !formula.esTautologica(c); }
+
+  // Quita (signo = -1) o vuelve a sumar (+1) el aporte de c al costo y a las unitarias
+  void aportar(int c, int signo)
+  {
+    if (!abierta(c))
+      return;
+    if (libres[c] == 0)
+      costo += signo * formula.peso(c);
+    else if (libres[c] <= 2)
+    {
+      vector<Peso> &destino = libres[c] == 1 ? unitarias : binarias;
+      for (const int *l = formula.literalesDe(c), *fin = formula.finDe(c); l != fin; l++)
+        if (valor[varDeLiteral(*l)] == TBool::Unknown)
+          destino[*l] += signo * formula.peso(c);
+    }
+  }
+
+  // Prioridad de ramificación: primero las que acotan (unitarias), luego las de más binarias en ambos signos
+  pair<Peso, Peso> prioridad(int v) const
+  {
+    return {unitarias[2 * v] + unitarias[2 * v + 1],
+            binarias[2 * v] * binarias[2 * v + 1] + binarias[2 * v] + binarias[2 * v + 1]};
+  }
+
+  // Asigna v (nuevo = True/False) o la desasigna (nuevo = Unknown, con su valor actual)
+  void cambiar(int v, TBool nuevo)
+  {
+    TBool actual = nuevo == TBool::Unknown ? valor[v] : nuevo;
+    int paso = nuevo == TBool::Unknown ? -1 : 1;
+    for (const int *o = formula.ocurrenciasDe(v), *fin = formula.finOcurrenciasDe(v); o != fin; o++)
+      aportar(*o >> 1, -1);
+    valor[v] = nuevo;
+    for (const int *o = formula.ocurrenciasDe(v), *fin = formula.finOcurrenciasDe(v); o != fin; o++)
+    {
+      int c = *o >> 1;
+      libres[c] -= paso;
+      if (literalVerdadero((v << 1) | (*o & 1), actual))
+        verdaderos[c] += paso;
+    }
+    for (const int *o = formula.ocurrenciasDe(v), *fin = formula.finOcurrenciasDe(v); o != fin; o++)
+      aportar(*o >> 1, 1);
+  }
+
+  Peso cota(const vector<int> &orden, int profundidad) const
+  {
+    Peso c = costo;
+    for (size_t i = profundidad; i < orden.size(); i++)
+      c += min(unitarias[2 * orden[i]], unitarias[2 * orden[i] + 1]);
+    return c;
+  }
+
+public:
+  explicit SolverExacto(const FormulaCompacta &f) : formula(f) {}
+
+  ResultadoExacto resolver(Peso cotaSuperior, ControlBusqueda &control)
+  {
+    auto start = chrono::high_resolution_clock::now();
+    int n = formula.getNumVariables(), m = formula.numClausulas();
+    valor.assign(n, TBool::Unknown);
+    verdaderos.assign(m, 0);
+    libres.resize(m);
+    unitarias.assign(2 * n, 0);
+    binarias.assign(2 * n, 0);
+    costo = 0;
+    for (int c = 0; c < m; c++)
+    {
+      libres[c] = formula.longitud(c);
+      aportar(c, 1);
+    }
+
+    // Primero las variables con más apariciones: las cotas suben antes
+    vector<int> orden(n);
+    iota(orden.begin(), orden.end(), 0);
+    stable_sort(orden.begin(), orden.end(), [this](int a, int b) {
+      return formula.finOcurrenciasDe(a) - formula.ocurrenciasDe(a) > formula.finOcurrenciasDe(b) - formula.ocurrenciasDe(b);
+    });
+
+    ResultadoExacto r;
+    r.cotaInferior = min(cota(orden, 0), cotaSuperior);
+    Peso mejor = cotaSuperior;
+    // intentos[d]: valores ya probados para orden[d] (0, 1 o 2)
+    vector<int8_t> intentos(n + 1, 0);
+    vector<TBool> primero(n);
+    int d = 0;
+    bool agotado = false;
+    PasosLocales pasos(control);
+    while (d >= 0 && mejor > r.cotaInferior)
+    {
+      if (!pasos.continuar())
+      {
+        agotado = true;
+        break;
+      }
+      if (d == n)
+      {
+        mejor = costo; // solo se llega con cota < mejor
+        d--;
+        continue;
+      }
+      // Al entrar a un nivel se ramifica sobre la libre con más peso en cláusulas que dependen solo de ella
+      if (intentos[d] == 0)
+      {
+        int elegida = d;
+        pair<Peso, Peso> mejorPrioridad = prioridad(orden[d]);
+        for (int i = d + 1; i < n; i++)
+          if (prioridad(orden[i]) > mejorPrioridad)
+          {
+            elegida = i;
+            mejorPrioridad = prioridad(orden[i]);
           }
+        swap(orden[d], orden[elegida]);
+      }
+      int v = orden[d];
+      if (intentos[d] > 0)
+        cambiar(v, TBool::Unknown);
+      if (intentos[d] == 2)
+      {
+        intentos[d] = 0;
+        d--;
+        continue;
+      }
+      // Primero el valor que satisface más peso de las cláusulas que dependen solo de v
+      if (intentos[d] == 0)
+        primero[d] = unitarias[2 * v] >= unitarias[2 * v + 1] ? TBool::True : TBool::False;
+      TBool probar = intentos[d] == 0 ? primero[d] : (primero[d] == TBool::True ? TBool::False : TBool::True);
+      intentos[d]++;
+      cambiar(v, probar);
+      if (cota(orden, d + 1) < mejor)
+        d++;
+    }
+    r.demostrado = !agotado;
+    r.costo = mejor;
+    if (r.demostrado)
+      r.cotaInferior = mejor;
+    r.segundos = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+    return r;
+  }
+};
+
+/**
+ * Caché del solver exacto en <archivo>.exacto, invalidado como el .cnfbin por
+ * el hash y el tamaño del texto fuente. Un óptimo demostrado se reutiliza
+ * siempre; una cota, solo si se obtuvo con un presupuesto no menor al pedido.
+ */
+bool leerCacheExacto(const string &nombre, uint64_t hashFuente, uint64_t tamFuente, double segundosPedidos,
+                     ResultadoExacto &r)
+{
+  ifstream in(nombre);
+  string magia;
+  uint64_t hash = 0, tam = 0;
+  double segundosUsados = 0;
+  if (!(in >> magia >> hash >> tam >> r.demostrado >> r.costo >> r.cotaInferior >> segundosUsados))
+    return false;
+  if (magia != "EXACTO01" || hash != hashFuente || tam != tamFuente)
+    return false;
+  return r.demostrado || segundosUsados >= segundosPedidos;
+}
+
+void escribirCacheExacto(const string &nombre, uint64_t hashFuente, uint64_t tamFuente, double segundosPedidos,
+                         const ResultadoExacto &r)
+{
+  string temporal = nombre + ".tmp" + to_string(getpid());
+  {
+    ofstream out(temporal);
+    out << "EXACTO01 " << hashFuente << " " << tamFuente << " " << r.demostrado << " " << r.costo << " "
+        << r.cotaInferior << " " << segundosPedidos << endl;
+    if (!out)
+    {
+      remove(temporal.c_str());
+      return;
+    }
+  }
+  if (rename(temporal.c_str(), nombre.c_str()) != 0)
+    remove(temporal.c_str());
+}
+
+/**
+ * Costo de la línea "o" de un archivo de solución; false si no existe o no
+ * tiene esa línea.
+ */
+bool leerCostoSolucion(const string &ruta, Peso &costo)
+{
+  ifstream in(ruta);
+  string linea;
+  while (getline(in, linea))
+    if (linea.size() > 2 && linea[0] == 'o' && linea[1] == ' ')
+    {
+      costo = strtoll(linea.c_str() + 2, nullptr, 10);
+      return true;
+    }
+  return false;
+}
+
+// El archivo en sí: temporal y rename, para que un lector nunca vea uno a medias
+bool escribirArchivoSolucion(const string &ruta, const string &comentario, Peso costo, bool optimo,
+                             const vector<TBool> &asignacion)
+{
+  string temporal = ruta + ".tmp" + to_string(getpid());
+  {
+    ofstream out(temporal);
+    out << "c " << comentario << "\n"
+        << "o " << costo << "\n"
+        << "s " << (optimo ? "OPTIMUM FOUND" : "UNKNOWN") << "\n";
+    string linea = "v";
+    for (size_t v = 0; v < asignacion.size(); v++)
+    {
+      string literal = (asignacion[v] == TBool::True ? " " : " -") + to_string(v + 1);
+      if (linea.size() + literal.size() > 80)
+      {
+        out << linea << "\n";
+        linea = "v";
+      }
+      linea += literal;
+    }
+    out << linea << " 0" << endl;
+    if (!out)
+    {
+      remove(temporal.c_str());
+      return false;
+    }
+  }
+  if (rename(temporal.c_str(), ruta.c_str()) != 0)
+  {
+    remove(temporal.c_str());
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Archivo de solución en el formato de las competencias: comentarios "c", el
+ * costo en "o", el estado en "s" y los literales de la asignación en líneas
+ * "v" terminadas en 0 (la última).
+ *
+ * Varios nodos de --nodo k/N escriben el mismo archivo, así que solo se
+ * reemplaza uno existente si costo es estrictamente menor que el suyo. La
+ * comparación y el rename van bajo un flock sobre ruta.lock, de modo que dos
+ * nodos que terminan a la vez no se pisan. Devuelve false solo ante un error.
+ */
+bool escribirSolucion(const string &ruta, const string &comentario, Peso costo, bool optimo, const vector<TBool> &asignacion)
+{
+  string rutaCerrojo = ruta + ".lock";
+  int cerrojo = open(rutaCerrojo.c_str(), O_WRONLY | O_CREAT, 0644);
+  if (cerrojo < 0 || flock(cerrojo, LOCK_EX) != 0)
+  {
+    if (cerrojo >= 0)
+      close(cerrojo);
+    return false;
+  }
+  bool ok = true;
+  Peso costoExistente;
+  if (!leerCostoSolucion(ruta, costoExistente) || costo < costoExistente)
+    ok = escribirArchivoSolucion(ruta, comentario, costo, optimo, asignacion);
+  close(cerrojo); // libera el flock
+  return ok;
+}
+
+/**
+ * Lee las líneas "v" de un archivo de solución sobre numVariables variables.
+ * Las variables que el archivo no menciona quedan en Unknown y los literales
+ * de variables que la instancia ya no tiene se ignoran, así una solución
+ * sirve de arranque para una versión modificada de la instancia. Devuelve
+ * cuántas variables tomaron valor, o -1 si el archivo no se puede leer.
+ */
+int leerSolucion(const string &ruta, int numVariables, vector<TBool> &asignacion)
+{
+  ifstream in(ruta);
+  if (!in)
+    return -1;
+  asignacion.assign(numVariables, TBool::Unknown);
+  int leidas = 0;
+  string linea;
+  while (getline(in, linea))
+  {
+    if (linea.empty() || linea[0] != 'v')
+      continue;
+    istringstream literales(linea.substr(1));
+    long long lit;
+    while (literales >> lit)
+    {
+      long long v = llabs(lit);
+      if (lit == 0 || v > numVariables)
+        continue;
+      leidas += asignacion[v - 1] == TBool::Unknown;
+      asignacion[v - 1] = lit > 0 ? TBool::True : TBool::False;
+    }
+  }
+  return leidas;
+}
+
+/**
+ * Tamaño de una instancia para ordenar la campaña: bytes del archivo y
+ * cláusulas declaradas en la línea p. Solo se leen los comentarios iniciales y
+ * el preámbulo, no el cuerpo. Un archivo ilegible queda en 0 y su error se
+ * informa al cargarlo.
+ */
+struct EstimacionInstancia
+{
+  size_t bytes = 0;
+  long long clausulas = 0;
+
+  bool operator>(const EstimacionInstancia &o) const
+  {
+    return bytes != o.bytes ? bytes > o.bytes : clausulas > o.clausulas;
+  }
+};
+
+EstimacionInstancia estimarInstancia(const string &nombreArchivo)
+{
+  EstimacionInstancia e;
+  ArchivoMapeado archivo;
+  if (!archivo.abrir(nombreArchivo))
+    return e;
+  e.bytes = archivo.getTamano();
+  EscanerDimacs esc(archivo.inicio(), archivo.fin());
+  while (esc.saltarBlancos() && esc.actual() == 'c')
+    esc.saltarLinea();
+  if (esc.saltarBlancos() && esc.actual() == 'p')
+  {
+    long long nVars = 0;
+    esc.avanzar();
+    esc.palabra();
+    esc.leerEntero(nVars, true);
+    esc.leerEntero(e.clausulas, true);
+  }
+  return e;
+}
+
+/**
+ * Preprocesado entre la carga y la búsqueda. Propaga las cláusulas duras
+ * unitarias, descarta las cláusulas satisfechas y los literales falsos,
+ * fusiona cláusulas repetidas (sumando sus pesos si son blandas), elimina las
+ * cláusulas subsumidas por una dura y fija los literales puros. Todas las
+ * reglas conservan los óptimos: una dura unitaria se cumple en toda solución
+ * factible, y un literal puro o una cláusula subsumida por una dura nunca
+ * cambian el costo de una solución factible. Una blanda no elimina a otra que
+ * la contiene, porque con pesos esa regla no es válida.
+ *
+ * Las variables que quedan se renumeran en orden en una fórmula reducida. La
+ * asignación de la búsqueda se reconstruye sobre las variables originales con
+ * reconstruir(); las variables sin ocurrencias quedan en False.
+ */
+class Preprocesador
+{
+private:
+  vector<TBool> fijas;   // valor impuesto por el preprocesado a cada variable original
+  vector<int> aOriginal; // variable reducida -> variable original
+  Peso costoFijo = 0;    // blandas que las fijaciones dejan falsificadas
+  int unitarias = 0, puras = 0, duplicadas = 0, subsumidas = 0;
+  double segundos = 0;
+
+  bool fijar(int lit, vector<int> &cola)
+  {
+    int v = varDeLiteral(lit);
+    if (fijas[v] != TBool::Unknown)
+      return literalVerdadero(lit, fijas[v]);
+    fijas[v] = esNegado(lit) ? TBool::False : TBool::True;
+    cola.push_back(v);
+    return true;
+  }
+
+public:
+  /**
+   * Reduce original en reducida. Devuelve false, sin tocar reducida, si las
+   * duras se contradicen durante la propagación o si no queda nada por buscar;
+   * en ese caso la búsqueda debe trabajar sobre la fórmula original.
+   */
+  bool reducir(const FormulaCompacta &original, FormulaCompacta &reducida)
+  {
+    auto start = chrono::high_resolution_clock::now();
+    int n = original.getNumVariables(), m = original.numClausulas();
+    fijas.assign(n, TBool::Unknown);
+    costoFijo = 0;
+    unitarias = puras = duplicadas = subsumidas = 0;
+
+    // 1. Propagación unitaria de las duras con contadores de literales falsos
+    vector<int> cola, falsos(m, 0);
+    vector<char> satisfecha(m, 0);
+    bool conflicto = false;
+    for (int c = 0; c < m && !conflicto; c++)
+      if (original.esDura(c) && !original.esTautologica(c) && original.longitud(c) <= 1)
+        conflicto = original.longitud(c) == 0 || !fijar(*original.literalesDe(c), cola);
+    for (size_t q = 0; q < cola.size() && !conflicto; q++)
+    {
+      int v = cola[q];
+      for (const int *o = original.ocurrenciasDe(v), *fin = original.finOcurrenciasDe(v); o != fin && !conflicto; o++)
+      {
+        int c = *o >> 1;
+        if (satisfecha[c])
+          continue;
+        if (literalVerdadero((v << 1) | (*o & 1), fijas[v]))
+        {
+          satisfecha[c] = 1;
+          continue;
+        }
+        int restantes = original.longitud(c) - ++falsos[c];
+        if (!original.esDura(c) || restantes > 1)
+          continue;
+        if (restantes == 0)
+          conflicto = true;
+        else
+          for (const int *l = original.literalesDe(c), *finL = original.finDe(c); l != finL; l++)
+            if (fijas[varDeLiteral(*l)] == TBool::Unknown)
+            {
+              fijar(*l, cola);
+              break;
+            }
+      }
+    }
+    if (conflicto)
+      return false;
+    unitarias = cola.size();
+
+    // 2. Cláusulas abiertas sin sus literales falsos, con los literales ordenados
+    vector<int> lits, ini{0};
+    vector<Peso> peso;
+    vector<char> dura;
+    lits.reserve(original.numLiterales());
+    for (int c = 0; c < m; c++)
+    {
+      if (satisfecha[c] || original.esTautologica(c))
+        continue;
+      size_t desde = lits.size();
+      for (const int *l = original.literalesDe(c), *fin = original.finDe(c); l != fin; l++)
+        if (fijas[varDeLiteral(*l)] == TBool::Unknown)
+          lits.push_back(*l);
+      if (lits.size() == desde)
+      {
+        costoFijo += original.peso(c); // blanda: una dura vacía habría sido un conflicto
+        continue;
+      }
+      sort(lits.begin() + desde, lits.end());
+      ini.push_back(lits.size());
+      peso.push_back(original.esDura(c) ? 0 : original.peso(c));
+      dura.push_back(original.esDura(c));
+    }
+    int k = (int)ini.size() - 1;
+    vector<char> viva(k, 1);
+    auto longitud = [&](int c) { return ini[c + 1] - ini[c]; };
+
+    // 3. Repetidas: se ordenan por contenido y cada grupo se fusiona en su primera cláusula
+    vector<int> orden(k);
+    iota(orden.begin(), orden.end(), 0);
+    auto menor = [&](int a, int b)
+    {
+      int la = longitud(a), lb = longitud(b);
+      if (la != lb)
+        return la < lb;
+      int r = memcmp(&lits[ini[a]], &lits[ini[b]], la * sizeof(int));
+      return r != 0 ? r < 0 : a < b;
+    };
+    sort(orden.begin(), orden.end(), menor);
+    for (int i = 1, g = 0; i < k; i++)
+    {
+      int a = orden[g], b = orden[i];
+      if (longitud(a) != longitud(b) || memcmp(&lits[ini[a]], &lits[ini[b]], longitud(a) * sizeof(int)) != 0)
+      {
+        g = i;
+        continue;
+      }
+      dura[a] = dura[a] || dura[b];
+      peso[a] = dura[a] ? 0 : peso[a] + peso[b];
+      viva[b] = 0;
+      duplicadas++;
+    }
+
+    // Ocurrencias por literal de las cláusulas vivas
+    vector<int> inicioOc(2 * n + 1, 0), oc;
+    for (int c = 0; c < k; c++)
+      if (viva[c])
+        for (int j = ini[c]; j < ini[c + 1]; j++)
+          inicioOc[lits[j] + 1]++;
+    partial_sum(inicioOc.begin(), inicioOc.end(), inicioOc.begin());
+    oc.resize(inicioOc[2 * n]);
+    vector<int> cursor(inicioOc.begin(), inicioOc.end() - 1);
+    for (int c = 0; c < k; c++)
+      if (viva[c])
+        for (int j = ini[c]; j < ini[c + 1]; j++)
+          oc[cursor[lits[j]]++] = c;
+    vector<int> vivas(2 * n); // ocurrencias vivas de cada literal
+    for (int l = 0; l < 2 * n; l++)
+      vivas[l] = inicioOc[l + 1] - inicioOc[l];
+    auto matar = [&](int c)
+    {
+      viva[c] = 0;
+      for (int j = ini[c]; j < ini[c + 1]; j++)
+        vivas[lits[j]]--;
+    };
+
+    // 4. Subsunción por duras: se recorren las cláusulas del literal menos frecuente
+    //    de cada dura. El trabajo se acota para que una fórmula densa no se quede aquí.
+    vector<int> marca(2 * n, -1);
+    long long trabajo = 0, limiteTrabajo = 20LL * lits.size() + 1000000;
+    for (int c = 0; c < k && trabajo < limiteTrabajo; c++)
+    {
+      if (!viva[c] || !dura[c])
+        continue;
+      int raro = lits[ini[c]];
+      for (int j = ini[c]; j < ini[c + 1]; j++)
+      {
+        marca[lits[j]] = c;
+        if (vivas[lits[j]] < vivas[raro])
+          raro = lits[j];
+      }
+      for (int i = inicioOc[raro]; i < inicioOc[raro + 1]; i++)
+      {
+        int d = oc[i];
+        if (d == c || !viva[d] || longitud(d) < longitud(c))
+          continue;
+        int comunes = 0;
+        for (int j = ini[d]; j < ini[d + 1]; j++)
+          comunes += marca[lits[j]] == c;
+        trabajo += longitud(d);
+        if (comunes == longitud(c))
+        {
+          matar(d);
+          subsumidas++;
+        }
+      }
+    }
+
+    // 5. Literales puros, en cascada: fijarlos satisface cláusulas y puede dejar puros a otros
+    cola.clear();
+    auto revisar = [&](int v)
+    {
+      if (fijas[v] == TBool::Unknown && (vivas[2 * v] == 0) != (vivas[2 * v + 1] == 0))
+        fijar(vivas[2 * v] > 0 ? 2 * v : 2 * v + 1, cola);
+    };
+    for (int v = 0; v < n; v++)
+      revisar(v);
+    for (size_t q = 0; q < cola.size(); q++)
+    {
+      int v = cola[q];
+      int lit = fijas[v] == TBool::True ? 2 * v : 2 * v + 1;
+      for (int i = inicioOc[lit]; i < inicioOc[lit + 1]; i++)
+        if (viva[oc[i]])
+        {
+          matar(oc[i]);
+          for (int j = ini[oc[i]]; j < ini[oc[i] + 1]; j++)
+            revisar(varDeLiteral(lits[j]));
+        }
+    }
+    puras = cola.size();
+
+    // 6. Renumeración de las variables que siguen apareciendo y fórmula reducida
+    vector<int> indice(n, 0);
+    aOriginal.clear();
+    for (int v = 0; v < n; v++)
+      if (fijas[v] == TBool::Unknown && vivas[2 * v] + vivas[2 * v + 1] > 0)
+      {
+        aOriginal.push_back(v);
+        indice[v] = aOriginal.size();
+      }
+    segundos = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+    if (aOriginal.empty())
+      return false;
+
+    reducida = FormulaCompacta(aOriginal.size());
+    reducida.reservar(k, lits.size());
+    vector<int> dimacs;
+    for (int c = 0; c < k; c++)
+    {
+      if (!viva[c])
+        continue;
+      dimacs.clear();
+      for (int j = ini[c]; j < ini[c + 1]; j++)
+        dimacs.push_back(esNegado(lits[j]) ? -indice[varDeLiteral(lits[j])] : indice[varDeLiteral(lits[j])]);
+      reducida.agregarClausula(dimacs, peso[c], dura[c]);
+    }
+    reducida.finalizar();
+    segundos = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+    return true;
+  }
+
+  // Asignación de las variables originales a partir de una de la fórmula reducida
+  void reconstruir(const vector<TBool> &reducida, vector<TBool> &original) const
+  {
+    original.assign(fijas.size(), TBool::False);
+    for (size_t v = 0; v < fijas.size(); v++)
+      if (fijas[v] != TBool::Unknown)
+        original[v] = fijas[v];
+    for (size_t i = 0; i < aOriginal.size(); i++)
+      original[aOriginal[i]] = reducida[i];
+  }
+
+  // Inversa de reconstruir(): la parte de una asignación original que ve la fórmula reducida
+  void proyectar(const vector<TBool> &original, vector<TBool> &reducida) const
+  {
+    reducida.resize(aOriginal.size());
+    for (size_t i = 0; i < aOriginal.size(); i++)
+      reducida[i] = original[aOriginal[i]];
+  }
+
+  Peso getCostoFijo() const { return costoFijo; }
+  int getUnitarias() const { return unitarias; }
+  int getPuras() const { return puras; }
+  int getDuplicadas() const { return duplicadas; }
+  int getSubsumidas() const { return subsumidas; }
+  double getSegundos() const { return segundos; }
+};
+
+/**
+ * Renumeración para localidad de memoria. Las variables se numeran por orden de
+ * primera aparición al recorrer las cláusulas, y luego las cláusulas se ordenan
+ * por su menor variable nueva (conteo por cubetas, O(literales)). Las variables
+ * de una misma cláusula quedan contiguas aunque el codificador las haya
+ * repartido por todo el rango. Las cláusulas que comparten variables quedan
+ * cerca en el arreglo de literales y en los contadores por cláusula. Así un
+ * flip toca menos líneas de caché.
+ *
+ * Cuthill-McKee inverso sobre el grafo de incidencia dejaba en Causal-Discovery
+ * niveles de BFS muy anchos: la dispersión media por cláusula subía de ~4.6k a
+ * ~135k variables y los flips no se aceleraban.
+ *
+ * Las asignaciones de la búsqueda se llevan a la numeración de entrada con
+ * reconstruir().
+ */
+class Reordenamiento
+{
+private:
+  vector<int> aOriginal; // variable interna -> variable de entrada
+  double dispersionAntes = 0, dispersionDespues = 0;
+  double segundos = 0;
+
+  // Distancia media entre la menor y la mayor variable de cada cláusula
+  static double dispersion(const FormulaCompacta &f)
+  {
+    double suma = 0;
+    for (int c = 0; c < f.numClausulas(); c++)
+    {
+      if (f.longitud(c) == 0)
+        continue;
+      int menor = numeric_limits<int>::max(), mayor = 0;
+      for (const int *l = f.literalesDe(c), *fin = f.finDe(c); l != fin; l++)
+      {
+        menor = min(menor, varDeLiteral(*l));
+        mayor = max(mayor, varDeLiteral(*l));
+      }
+      suma += mayor - menor;
+    }
+    return f.numClausulas() > 0 ? suma / f.numClausulas() : 0;
+  }
+
+public:
+  // Escribe en reordenada la fórmula renumerada; false si no tiene variables
+  bool reordenar(const FormulaCompacta &original, FormulaCompacta &reordenada)
+  {
+    auto start = chrono::high_resolution_clock::now();
+    int n = original.getNumVariables(), m = original.numClausulas();
+    if (n == 0)
+      return false;
+    // 1. Primera aparición en el orden de las cláusulas; al final las variables sin ocurrencias
+    vector<char> vista(n, 0);
+    aOriginal.clear();
+    aOriginal.reserve(n);
+    for (int c = 0; c < m; c++)
+      for (const int *l = original.literalesDe(c), *fin = original.finDe(c); l != fin; l++)
+        if (!vista[varDeLiteral(*l)])
+        {
+          vista[varDeLiteral(*l)] = 1;
+          aOriginal.push_back(varDeLiteral(*l));
+        }
+    for (int v = 0; v < n; v++)
+      if (!vista[v])
+        aOriginal.push_back(v);
+    vector<int> nueva(n);
+    for (int i = 0; i < n; i++)
+      nueva[aOriginal[i]] = i;
+
+    // 2. Cláusulas por su menor variable nueva (conteo por cubetas, estable)
+    vector<int> clave(m, n), inicioCubeta(n + 2, 0);
+    for (int c = 0; c < m; c++)
+    {
+      for (const int *l = original.literalesDe(c), *fin = original.finDe(c); l != fin; l++)
+        clave[c] = min(clave[c], nueva[varDeLiteral(*l)]);
+      inicioCubeta[clave[c] + 1]++;
+    }
+    for (int i = 0; i <= n; i++)
+      inicioCubeta[i + 1] += inicioCubeta[i];
+    vector<int> clausulas(m);
+    for (int c = 0; c < m; c++)
+      clausulas[inicioCubeta[clave[c]]++] = c;
+
+    // 3. Fórmula renumerada; las duras conservan su marca y finalizar() recalcula su peso
+    reordenada = FormulaCompacta(n);
+    reordenada.reservar(m, original.numLiterales());
+    vector<int> dimacs;
+    for (int c : clausulas)
+    {
+      dimacs.clear();
+      for (const int *l = original.literalesDe(c), *fin = original.finDe(c); l != fin; l++)
+        dimacs.push_back(esNegado(*l) ? -(nueva[varDeLiteral(*l)] + 1) : nueva[varDeLiteral(*l)] + 1);
+      reordenada.agregarClausula(dimacs, original.esDura(c) ? 1 : original.peso(c), original.esDura(c));
+    }
+    reordenada.finalizar();
+    dispersionAntes = dispersion(original);
+    dispersionDespues = dispersion(reordenada);
+    segundos = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+    return true;
+  }
+
+  // Asignación en la numeración de entrada a partir de una en la numeración interna
+  void reconstruir(const vector<TBool> &interna, vector<TBool> &original) const
+  {
+    original.resize(aOriginal.size());
+    for (size_t i = 0; i < aOriginal.size(); i++)
+      original[aOriginal[i]] = interna[i];
+  }
+
+  void proyectar(const vector<TBool> &original, vector<TBool> &interna) const
+  {
+    interna.resize(aOriginal.size());
+    for (size_t i = 0; i < aOriginal.size(); i++)
+      interna[i] = original[aOriginal[i]];
+  }
+
+  double getDispersionAntes() const { return dispersionAntes; }
+  double getDispersionDespues() const { return dispersionDespues; }
+  double getSegundos() const { return segundos; }
+};
+
+// Funciones estadísticas
+double promedio(const vector<double> &v)
+{
+  if (v.empty())
+    return 0.0;
+  return accumulate(v.begin(), v.end(), 0.0) / v.size();
+}
+
+double desviacionEstandar(const vector<double> &v, const double media)
+{
+  if (v.size() < 2)
+    return 0.0;
+  double sumCuadrados = accumulate(v.begin(), v.end(), 0.0,
+      [media](double acc, double val) {
+          return acc + pow(val - media, 2);
+      });
+  return sqrt(sumCuadrados / (v.size() - 1));
+}
+
+string formatearMedida(double media, double desv_est) {
+    if (desv_est <= 0) return to_string(media) + "(0)";
+
+    // 1. Encontrar la posición de la primera cifra significativa de la desv. estándar
+    // Log10 nos dice la magnitud. Floor nos da el exponente entero.
+    int exponente = floor(log10(desv_est));
+    
+    // 2. Extraer esa primera cifra
+    // Multiplicamos para que la cifra sea la unidad, y redondeamos.
+    int cifra = round(desv_est / pow(10, exponente));
+    
+    // Caso especial: si el redondeo nos lleva a 10 (ej: 0.099 -> 0.1)
+    if (cifra == 10) {
+        cifra = 1;
+        exponente++;
+    }
 
-          // 4. Ejecutar el mejor movimiento encontrado (aunque sea peor que el actual)
-          if (mejorVarIdx != -1) 
-          {
-              vars[mejorVarIdx] = (vars[mejorVarIdx] == TBool::True) ? TBool::False : TBool::True;
-              costoActual += mejorDelta;
-              
-              // Actualizar lista tabú con tenure variable
-              tabuUntil[mejorVarIdx] = iter + tenureBase + disTenure(gen);
+    // 3. Formatear la media con la precisión adecuada
+    stringstream ss;
+    if (exponente < 0) {
+        // Si la cifra está en los decimales
+        ss << fixed << setprecision(abs(exponente)) << media;
+    } else {
+        // Si la cifra es mayor o igual a 1, redondeamos a la unidad/decena pertinente
+        double factor = pow(10, exponente);
+        ss << fixed << setprecision(0) << round(media / factor) * factor;
+    }
 
-              // Actualizar mejor global si aplica
-              if (costoActual < mejorCostoGlobal) 
-              {
-                  mejorCostoGlobal = costoActual;
-                  mejorSolucionGlobal = vars;
-              }
+    // 4. Construir el string final
+    return ss.str() + "(" + to_string(cifra) + ")";
+}
+
+/**
+ * Salida en streaming de un registro por corrida y método (CSV, o JSON lines
+ * si la ruta termina en .jsonl/.json). Cada hilo OpenMP escribe en su propio
+ * buffer sin bloqueos; al pasar de UMBRAL bytes (o tras un segundo sin
+ * entregar, para poder seguir la campaña) lo entrega a una pila sin bloqueos
+ * (CAS sobre la cabeza) y un hilo escritor la vuelca al archivo en segundo
+ * plano, así la consola y el disco no serializan a los hilos.
+ */
+class SalidaRegistros
+{
+public:
+  struct Registro
+  {
+    const string &instancia;
+    int corrida;
+    const char *algoritmo;
+    uint64_t semilla;
+    Peso costo;
+    double segundos;
+    long long flips;
+  };
+
+private:
+  struct Bloque
+  {
+    string texto;
+    Bloque *siguiente = nullptr;
+  };
+  struct alignas(64) BufferHilo
+  {
+    string texto;
+    chrono::steady_clock::time_point ultimaEntrega = chrono::steady_clock::now();
+  };
+
+  static const size_t UMBRAL = 1 << 16;
+  bool jsonl = false;
+  ofstream out;
+  vector<BufferHilo> buffers;
+  atomic<Bloque *> pendientes{nullptr};
+  atomic<bool> terminar{false};
+  mutex mtxEspera; // solo para dormir al escritor
+  condition_variable aviso;
+  thread escritor;
+
+  void entregar(string &texto)
+  {
+    Bloque *b = new Bloque{move(texto)};
+    texto = string();
+    texto.reserve(UMBRAL + 256);
+    b->siguiente = pendientes.load(memory_order_relaxed);
+    while (!pendientes.compare_exchange_weak(b->siguiente, b, memory_order_release, memory_order_relaxed))
+      ;
+    aviso.notify_one();
+  }
+
+  // Toma toda la pila de una vez y la escribe en orden de entrega
+  void vaciar()
+  {
+    Bloque *b = pendientes.exchange(nullptr, memory_order_acquire);
+    Bloque *fifo = nullptr;
+    while (b)
+    {
+      Bloque *sig = b->siguiente;
+      b->siguiente = fifo;
+      fifo = b;
+      b = sig;
+    }
+    while (fifo)
+    {
+      out << fifo->texto;
+      Bloque *sig = fifo->siguiente;
+      delete fifo;
+      fifo = sig;
+    }
+    out.flush();
+  }
+
+  void bucleEscritor()
+  {
+    while (!terminar.load(memory_order_acquire))
+    {
+      {
+        unique_lock<mutex> lock(mtxEspera);
+        aviso.wait_for(lock, chrono::milliseconds(100));
+      }
+      vaciar();
+    }
+    vaciar();
+  }
+
+  static string escaparJson(const string &t)
+  {
+    string r;
+    for (char ch : t)
+    {
+      if (ch == '"' || ch == '\\')
+        r += '\\';
+      r += ch;
+    }
+    return r;
+  }
+
+  static string escaparCsv(const string &t)
+  {
+    if (t.find_first_of(",\"\n") == string::npos)
+      return t;
+    string r = "\"";
+    for (char ch : t)
+      r += ch == '"' ? string("\"\"") : string(1, ch);
+    return r + "\"";
+  }
+
+public:
+  SalidaRegistros(const string &ruta, int numHilos) : out(ruta), buffers(max(1, numHilos))
+  {
+    jsonl = (ruta.size() >= 6 && ruta.compare(ruta.size() - 6, 6, ".jsonl") == 0) ||
+            (ruta.size() >= 5 && ruta.compare(ruta.size() - 5, 5, ".json") == 0);
+    if (!out)
+      return;
+    if (!jsonl)
+      out << "instancia,corrida,algoritmo,semilla,costo,segundos,flips\n";
+    for (BufferHilo &b : buffers)
+      b.texto.reserve(UMBRAL + 256);
+    escritor = thread(&SalidaRegistros::bucleEscritor, this);
+  }
+
+  ~SalidaRegistros() { cerrar(); }
+
+  bool valida() const { return escritor.joinable(); }
+
+  void escribir(const Registro &r)
+  {
+    char numeros[160];
+    BufferHilo &buffer = buffers[omp_get_thread_num() % buffers.size()];
+    string &texto = buffer.texto;
+    if (jsonl)
+    {
+      snprintf(numeros, sizeof(numeros), "\"semilla\":%llu,\"costo\":%lld,\"segundos\":%.9g,\"flips\":%lld}\n",
+               (unsigned long long)r.semilla, (long long)r.costo, r.segundos, r.flips);
+      texto += "{\"instancia\":\"" + escaparJson(r.instancia) + "\",\"corrida\":" + to_string(r.corrida) +
+               ",\"algoritmo\":\"" + r.algoritmo + "\",";
+    }
+    else
+    {
+      snprintf(numeros, sizeof(numeros), "%llu,%lld,%.9g,%lld\n", (unsigned long long)r.semilla, (long long)r.costo,
+               r.segundos, r.flips);
+      texto += escaparCsv(r.instancia) + "," + to_string(r.corrida) + "," + r.algoritmo + ",";
+    }
+    texto += numeros;
+    auto ahora = chrono::steady_clock::now();
+    if (texto.size() >= UMBRAL || ahora - buffer.ultimaEntrega >= chrono::seconds(1))
+    {
+      entregar(texto);
+      buffer.ultimaEntrega = ahora;
+    }
+  }
+
+  // Fuera de la región paralela: entrega los buffers parciales y espera al escritor
+  void cerrar()
+  {
+    if (!escritor.joinable())
+      return;
+    for (BufferHilo &b : buffers)
+      if (!b.texto.empty())
+        entregar(b.texto);
+    terminar.store(true, memory_order_release);
+    aviso.notify_one();
+    escritor.join();
+  }
+};
+
+/**
+ * Mejores costos conocidos por instancia, compartidos entre los nodos de una
+ * campaña a través de un archivo de solo agregado en un sistema de archivos
+ * común (--mejores ruta). Cada mejora local agrega una línea "instancia costo"
+ * con un único write() en O_APPEND, y un hilo relee cada 500 ms lo que otros
+ * agregaron desde el último byte leído. Los controles de búsqueda solo
+ * consultan el valor en memoria. Las instancias se identifican por su nombre
+ * sin directorio, así cada nodo puede tenerlas en otra ruta.
+ */
+class MejoresCompartidos
+{
+private:
+  string ruta;
+  mutex mtx;
+  map<string, unique_ptr<MejorConocido>> porInstancia;
+  off_t leido = 0;
+  string resto; // línea incompleta al final de la última lectura
+  atomic<bool> terminar{false};
+  mutex mtxEspera;
+  condition_variable aviso;
+  thread lector;
+
+  MejorConocido &entrada(const string &instancia)
+  {
+    unique_ptr<MejorConocido> &e = porInstancia[instancia];
+    if (!e)
+      e = make_unique<MejorConocido>();
+    return *e;
+  }
+
+  void releer()
+  {
+    int fd = open(ruta.c_str(), O_RDONLY);
+    if (fd < 0)
+      return;
+    string nuevo;
+    char bloque[1 << 16];
+    ssize_t leidos;
+    while ((leidos = pread(fd, bloque, sizeof(bloque), leido)) > 0)
+    {
+      nuevo.append(bloque, leidos);
+      leido += leidos;
+    }
+    close(fd);
+    resto += nuevo;
+    size_t fin = resto.rfind('\n');
+    if (fin == string::npos)
+      return;
+    istringstream lineas(resto.substr(0, fin));
+    resto.erase(0, fin + 1);
+    string instancia;
+    long long costo;
+    lock_guard<mutex> lock(mtx);
+    while (lineas >> instancia >> costo)
+      entrada(instancia).actualizar(costo);
+  }
+
+  void bucleLector()
+  {
+    while (!terminar.load(memory_order_acquire))
+    {
+      releer();
+      unique_lock<mutex> lock(mtxEspera);
+      aviso.wait_for(lock, chrono::milliseconds(500));
+    }
+  }
+
+public:
+  explicit MejoresCompartidos(const string &r) : ruta(r)
+  {
+    releer();
+    lector = thread(&MejoresCompartidos::bucleLector, this);
+  }
+
+  ~MejoresCompartidos()
+  {
+    terminar.store(true, memory_order_release);
+    aviso.notify_one();
+    lector.join();
+  }
+
+  // El valor vive tanto como el objeto, así que los controles pueden guardar la referencia
+  const MejorConocido &de(const string &instancia)
+  {
+    lock_guard<mutex> lock(mtx);
+    return entrada(instancia);
+  }
+
+  void publicar(const string &instancia, Peso costo)
+  {
+    {
+      lock_guard<mutex> lock(mtx);
+      if (!entrada(instancia).actualizar(costo))
+        return;
+    }
+    string linea = instancia + " " + to_string(costo) + "\n";
+    int fd = open(ruta.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0 || write(fd, linea.data(), linea.size()) != (ssize_t)linea.size())
+      cerr << "Aviso: no se pudo agregar a " << ruta << endl;
+    if (fd >= 0)
+      close(fd);
+  }
+};
+
+// Opciones de línea de comandos
+struct Opciones
+{
+  bool usarCache = false; // --cache: reutiliza/genera <archivo>bin junto a cada instancia
+  bool porBloques = false; // --por-bloques: lee el texto en bloques en lugar de proyectarlo entero
+  int precarga = 2;        // --precarga N: instancias parseadas por adelantado en un hilo aparte (0 = cada tarea carga la suya)
+  int hilosTabu = 1;      // --hilos-tabu N: trayectorias de la tabú cooperativa (1 = secuencial)
+  ParametrosSLS sls;      // --sls walksat|probsat|paws: política de la búsqueda focalizada
+  ParametrosSA sa;        // --sa-adaptativo: enfriamiento adaptativo con recalentamiento
+  Presupuesto presupuesto; // --tiempo-ms, --max-flips, --objetivo, --max-sin-mejora (por llamada a cada método)
+  bool trazarMejoras = false; // --anytime: informa por stderr cada mejora de cada método
+  bool lsFocalizada = false; // --ls-focalizada: ILS y GRASP mejoran con la búsqueda focalizada
+  bool perfil = false;        // --perfil: contadores y tiempos por fase y por método
+  string rutaRegistros;       // --registros ruta.csv|ruta.jsonl: un registro por corrida y método
+  bool preprocesar = false;   // --preprocesar: unitarias, repetidas, subsunción y puras antes de buscar
+  bool reordenar = false;     // --reordenar: renumera variables y cláusulas para localidad (tras preprocesar)
+  double segundosExacto = 0;   // --exacto-ms T: ramificación y acotamiento hasta T ms por instancia
+  bool bench = false;          // --bench: mediciones fijas por instancia en lugar del reporte
+  string rutaLineaBase;        // --linea-base ruta: compara --bench con una línea base
+  string rutaGuardarBase;      // --guardar-base ruta: escribe la línea base de este --bench
+  double toleranciaBench = 0.1; // --tolerancia x: caída de ritmo admitida antes de marcar regresión
+  bool repetirCorrida = false; // --semilla S: una sola corrida con la semilla S (la de un registro)
+  uint64_t semillaCorrida = 0;
+  int corridaRepetida = -1;    // --corrida i: una sola corrida, la i (con --semilla, solo fija su número)
+  int nodo = 0, numNodos = 1;  // --nodo k/N: este proceso corre solo su parte de las corridas
+  MejoresCompartidos *mejores = nullptr; // --mejores ruta: mejores costos compartidos entre nodos
+  string rutaSoluciones;       // --soluciones dir: dir/<instancia sin .cnf>.sol con la mejor asignación (si mejora la ya guardada)
+  string rutaInicio;           // --inicio dir|archivo.sol: arranque en caliente desde una solución guardada
+};
+
+string nombreSinDirectorio(const string &nombreArchivo)
+{
+  size_t barra = nombreArchivo.find_last_of('/');
+  return barra == string::npos ? nombreArchivo : nombreArchivo.substr(barra + 1);
+}
+
+/**
+ * Corridas de la instancia que le tocan a este nodo con --nodo k/N. Se reparten
+ * en rondas (la corrida iter va al nodo (iter + desfase) mod N), con un desfase
+ * por instancia para que las corridas que sobran no caigan siempre en los
+ * primeros nodos. Todos los nodos llegan al mismo reparto sin comunicarse.
+ */
+vector<int> corridasDelNodo(const string &nombreArchivo, const Opciones &opciones)
+{
+  // Una repetición conserva el número de la corrida original: el de --corrida o,
+  // si no se dio, el de la corrida cuya semilla derivada es la de --semilla
+  if (opciones.corridaRepetida >= 0)
+    return {opciones.corridaRepetida};
+  string nombreBase = nombreSinDirectorio(nombreArchivo);
+  if (opciones.repetirCorrida)
+  {
+    uint64_t semillaInstancia = hashContenido(nombreBase.data(), nombreBase.size());
+    for (int iter = 0; iter < NUM_CORRIDAS; iter++)
+      if (derivarSemilla(semillaInstancia, iter) == opciones.semillaCorrida)
+        return {iter};
+    return {0};
+  }
+  int desfase = hashContenido(nombreBase.data(), nombreBase.size()) % opciones.numNodos;
+  vector<int> corridas;
+  for (int iter = 0; iter < NUM_CORRIDAS; iter++)
+    if ((iter + desfase) % opciones.numNodos == opciones.nodo)
+      corridas.push_back(iter);
+  return corridas;
+}
+
+// Trabajo de un método en una corrida, para el reporte de --perfil
+struct PerfilMetodo
+{
+  Contadores contadores;
+  double segundos = 0;
+  double segundosMejor = 0; // desde el inicio del método hasta su mejor costo
+};
+
+const char *const METODOS_PERFIL[] = {"LS", "ILS", "TS", "SA", "GRASP", "SLS"};
+const int NUM_METODOS_PERFIL = 6;
+
+// Columnas de método del reporte y de los registros: H seguida de METODOS_PERFIL
+const char *const COLUMNAS_REPORTE[] = {"H", "LS", "ILS", "TS", "SA", "GRASP", "SLS"};
+const int NUM_COLUMNAS_REPORTE = 7;
+
+void imprimirEncabezado()
+{
+  cout << "==========================================================================================================" << endl;
+  cout << " REPORTE COMPARATIVO 30 REPETICIONES: Heurística vs Búsqueda Local (LS) vs Búsqueda Local Iterada (ILS)" << endl;
+  cout << "==========================================================================================================" << endl;
+
+  // Encabezados ajustados para 3 metodos
+  cout << left << setw(35) << "Archivo"
+       << "| " << setw(9) << "Exacto"
+       << "| " << setw(10) << "Costo H"
+       << "| " << setw(10) << "T. H(s)"
+       << "| " << setw(10) << "Costo LS"
+       << "| " << setw(10) << "T. LS(s)"
+       << "| " << setw(11) << "Costo ILS"
+       << "| " << setw(11) << "T. ILS(s)"
+       << "| " << setw(11) << "Costo TS"
+       << "| " << setw(11) << "T. TS(s)"
+       << "| " << setw(11) << "Costo SA"
+       << "| " << setw(11) << "T. SA(s)"
+       << "| " << setw(11) << "C. GRASP"
+       << "| " << setw(11) << "T. GRASP(s)"
+       << "| " << setw(11) << "Costo SLS"
+       << "| " << setw(11) << "T. SLS(s)"
+       << "| " << setw(6) << "Gap H-I%" << endl;
+  cout << "----------------------------------------------------------------------------------------------------------" << endl;
+}
+
+/**
+ * Fila del reporte: media(σ) de los costos y tiempos por corrida de cada
+ * columna de COLUMNAS_REPORTE y la mejora media de ILS sobre la heurística.
+ */
+void imprimirFila(const string &nombreArchivo, const string &textoExacto, const vector<double> *const costos[],
+                  const vector<double> *const tiempos[])
+{
+  string nombreCorto = (nombreArchivo.length() > 33) ? "..." + nombreArchivo.substr(nombreArchivo.length() - 30) : nombreArchivo;
+  cout << left << setw(35) << nombreCorto << "| " << setw(9) << textoExacto;
+  for (int k = 0; k < NUM_COLUMNAS_REPORTE; k++)
+  {
+    int ancho = k < 2 ? 10 : 11;
+    double mc = promedio(*costos[k]), mt = promedio(*tiempos[k]);
+    cout << "| " << setw(ancho) << formatearMedida(mc, desviacionEstandar(*costos[k], mc))
+         << "| " << setw(ancho) << formatearMedida(mt, desviacionEstandar(*tiempos[k], mt));
+  }
+  double mCH = promedio(*costos[0]), mCILS = promedio(*costos[2]);
+  double mejora = (mCH > 0) ? ((mCH - mCILS) / mCH) * 100.0 : 0.0;
+  cout << "| " << setw(5) << mejora << "%" << endl;
+}
+
+/**
+ * Ejecuta las NUM_CORRIDAS corridas de los seis métodos sobre una instancia ya
+ * cargada, repartidas como tareas OpenMP, e imprime su fila del reporte. La
+ * semilla de la corrida iter se deriva del nombre del archivo (sin directorio)
+ * e iter, y cada método usa su propio generador derivado de ella: los
+ * resultados no dependen del número de hilos ni de los métodos que corran antes.
+ */
+void resolverInstancia(const string &nombreArchivo, const FormulaCompacta &formulaBase, const EstadisticasCarga &carga,
+                       const Opciones &opciones, SalidaRegistros *salida)
+{
+#pragma omp critical
+  cerr << "Carga " << nombreArchivo << ": " << fixed << setprecision(1) << carga.bytes / (1024.0 * 1024.0)
+       << " MB en " << setprecision(3) << carga.segundos << " s (" << setprecision(1) << carga.mbPorSegundo()
+       << " MB/s" << (carga.desdeCache ? ", caché" : "") << "); fórmula " << formulaBase.bytesMemoria() / (1024.0 * 1024.0)
+       << " MB (literales " << formulaBase.bytesLiterales() / (1024.0 * 1024.0) << " MB)" << defaultfloat << endl;
+
+  // Con --preprocesar los métodos buscan sobre la fórmula reducida; los costos del
+  // reporte se evalúan sobre la original tras reconstruir la asignación completa
+  Preprocesador preprocesado;
+  FormulaCompacta formulaReducida;
+  bool reducida = opciones.preprocesar && preprocesado.reducir(formulaBase, formulaReducida);
+  const FormulaCompacta &formulaPreprocesada = reducida ? formulaReducida : formulaBase;
+  if (opciones.preprocesar)
+  {
+#pragma omp critical
+    {
+      cerr << "Preprocesado " << nombreArchivo << ": ";
+      if (reducida)
+        cerr << preprocesado.getUnitarias() << " unitarias, " << preprocesado.getPuras() << " puras, "
+             << preprocesado.getDuplicadas() << " repetidas, " << preprocesado.getSubsumidas()
+             << " subsumidas; quedan " << formulaPreprocesada.getNumVariables() << " de " << formulaBase.getNumVariables()
+             << " variables y " << formulaPreprocesada.numClausulas() << " de " << formulaBase.numClausulas()
+             << " cláusulas, costo fijo " << preprocesado.getCostoFijo();
+      else
+        cerr << "sin reducción (duras contradictorias o fórmula resuelta), se busca sobre la original";
+      cerr << " (" << preprocesado.getSegundos() << " s)" << endl;
+    }
+  }
+  // Con --reordenar se busca sobre la fórmula (ya preprocesada) renumerada
+  Reordenamiento reorden;
+  FormulaCompacta formulaReordenada;
+  bool reordenada = opciones.reordenar && reorden.reordenar(formulaPreprocesada, formulaReordenada);
+  const FormulaCompacta &formulaBusqueda = reordenada ? formulaReordenada : formulaPreprocesada;
+  if (reordenada)
+  {
+#pragma omp critical
+    cerr << "Reordenado " << nombreArchivo << ": dispersión media por cláusula " << fixed << setprecision(1)
+         << reorden.getDispersionAntes() << " -> " << reorden.getDispersionDespues() << " variables ("
+         << setprecision(3) << reorden.getSegundos() << " s)" << defaultfloat << endl;
+  }
+  const vector<Conteo> &frecuenciasBase = formulaBusqueda.getFrecuencias();
+  int numVariables = formulaBusqueda.getNumVariables();
+
+  // Una sola Formula por archivo: solo referencia a la representación compacta
+  Formula problema(formulaBusqueda);
+  Formula problemaOriginal(formulaBase);
+  // Asignación de la búsqueda llevada a las variables del archivo
+  auto aEntrada = [&](const vector<TBool> &asignacion)
+  {
+    vector<TBool> entrada = asignacion, completa;
+    if (reordenada)
+      reorden.reconstruir(asignacion, entrada);
+    if (!reducida)
+      return entrada;
+    preprocesado.reconstruir(entrada, completa);
+    return completa;
+  };
+  auto costoOriginal = [&](const vector<TBool> &asignacion) -> double
+  {
+    if (!reducida && !reordenada)
+      return problema.calcularCosto(asignacion);
+    return problemaOriginal.calcularCosto(aEntrada(asignacion));
+  };
+  // Sobre la fórmula reducida el objetivo y los avisos se desplazan por el costo
+  // fijo. El desplazamiento solo es exacto sin duras falsificadas: la reducida
+  // calcula su peso de duras con sus propias blandas, así que un costo desde
+  // getPesoDuro() (alguna dura falsa) no dice cuánto cobraría la original
+  Peso costoFijo = reducida ? preprocesado.getCostoFijo() : 0;
+  Peso limiteFactible = reducida ? formulaBusqueda.getPesoDuro() : numeric_limits<Peso>::max();
+  Presupuesto presupuesto = opciones.presupuesto;
+  if (presupuesto.costoObjetivo >= 0)
+    presupuesto.costoObjetivo = min(max<Peso>(0, presupuesto.costoObjetivo - costoFijo), limiteFactible - 1);
+  // Presupuesto de flips de la búsqueda focalizada (columna SLS y paso de LS)
+  long long flipsSLS = max<long long>(100000, 10LL * numVariables);
+  if (opciones.lsFocalizada)
+    problema.usarBusquedaFocalizada(opciones.sls, flipsSLS / 20);
+
+  // Con un presupuesto limitado los métodos corren hasta agotarlo en lugar de
+  // parar por sus contadores fijos de iteraciones
+  bool porPresupuesto = ControlBusqueda(presupuesto).limitado();
+  auto iteraciones = [porPresupuesto](int fijas) { return porPresupuesto ? numeric_limits<int>::max() : fijas; };
+  long long flipsColumnaSLS = porPresupuesto ? numeric_limits<long long>::max() : flipsSLS;
+
+  string nombreBase = nombreSinDirectorio(nombreArchivo);
+  uint64_t semillaInstancia = hashContenido(nombreBase.data(), nombreBase.size());
+  // Con --nodo solo las corridas de este nodo; los vectores van por posición, los registros por corrida
+  const vector<int> corridas = corridasDelNodo(nombreArchivo, opciones);
+  const int numCorridas = corridas.size();
+  if (numCorridas == 0)
+    return;
+  const MejorConocido *mejorExterno = opciones.mejores ? &opciones.mejores->de(nombreBase) : nullptr;
+
+  // Con --inicio la construcción de cada corrida parte de la solución guardada
+  // (llevada a la fórmula de búsqueda) y solo completa las variables que falten
+  string nombreSolucion = nombreBase.substr(0, nombreBase.rfind('.')) + ".sol";
+  vector<TBool> inicioBusqueda(numVariables, TBool::Unknown);
+  if (!opciones.rutaInicio.empty())
+  {
+    struct stat info;
+    bool esDirectorio = stat(opciones.rutaInicio.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+    string ruta = esDirectorio ? opciones.rutaInicio + "/" + nombreSolucion : opciones.rutaInicio;
+    vector<TBool> entrada, reducidaInicio;
+    int leidas = leerSolucion(ruta, formulaBase.getNumVariables(), entrada);
+    if (leidas > 0)
+    {
+      if (reducida)
+        preprocesado.proyectar(entrada, reducidaInicio);
+      else
+        reducidaInicio.swap(entrada);
+      if (reordenada)
+        reorden.proyectar(reducidaInicio, inicioBusqueda);
+      else
+        inicioBusqueda.swap(reducidaInicio);
+    }
+#pragma omp critical
+    cerr << "Inicio " << nombreArchivo << ": " << (leidas < 0 ? 0 : leidas) << " de " << formulaBase.getNumVariables()
+         << " variables desde " << ruta << endl;
+  }
+
+  // Con --soluciones, la mejor asignación de todas las corridas y métodos (a igual
+  // costo gana la de menor corrida y columna, sin depender del reparto entre hilos)
+  mutex mtxSolucion;
+  double costoSolucion = numeric_limits<double>::max();
+  pair<int, int> origenSolucion{NUM_CORRIDAS, 0};
+  vector<TBool> mejorSolucion;
+
+  // Vectores para guardar promedios de los metodos (una posición por corrida)
+  vector<double> tH(numCorridas), tLS(numCorridas), tILS(numCorridas), tTS(numCorridas), tSA(numCorridas), tGRASP(numCorridas), tSLS(numCorridas);
+  vector<double> cH(numCorridas), cLS(numCorridas), cILS(numCorridas), cTS(numCorridas), cSA(numCorridas), cGRASP(numCorridas), cSLS(numCorridas);
+  vector<vector<PerfilMetodo>> perfiles(numCorridas, vector<PerfilMetodo>(NUM_METODOS_PERFIL));
+
+  // Las corridas comparten la fórmula de solo lectura; cada una con sus generadores
+#pragma omp taskloop grainsize(1) default(shared)
+  for (int r = 0; r < numCorridas; r++)
+  {
+    int iter = corridas[r];
+    uint64_t semilla = opciones.repetirCorrida ? opciones.semillaCorrida : derivarSemilla(semillaInstancia, iter);
+    // Un flujo por método (índice de METODOS_PERFIL)
+    auto generador = [semilla](int metodo) { return Generador(derivarSemilla(semilla, metodo + 1)); };
+    Generador genILS = generador(1), genTS = generador(2), genSA = generador(3), genGRASP = generador(4),
+              genSLS = generador(5);
+    // Memoria de trabajo de la corrida, reutilizada por todos los métodos
+    auto espacio = problema.prestarEspacio();
+    EspacioTrabajo &ws = *espacio;
+    // Control de terminación de cada método; el reloj y los contadores empiezan al crearlo
+    Contadores antes;
+    auto control = [&](const char *metodo)
+    {
+      antes = ws.ev.getContadores();
+      function<void(Peso, double)> aviso;
+      if (opciones.trazarMejoras || opciones.mejores)
+        aviso = [&nombreArchivo, &nombreBase, &opciones, metodo, iter, costoFijo, limiteFactible](Peso costo,
+                                                                                                 double segundos)
+        {
+          // Un costo infactible de la reducida no se publica: subestimaría el de la original
+          bool exacto = costo < limiteFactible;
+          if (opciones.mejores && exacto)
+            opciones.mejores->publicar(nombreBase, costo + costoFijo);
+          if (!opciones.trazarMejoras)
+            return;
+#pragma omp critical
+          {
+            cerr << "mejora " << nombreArchivo << " " << metodo << " corrida " << iter << ": ";
+            if (exacto)
+              cerr << costo + costoFijo;
+            else
+              cerr << "infactible (" << costo << " en la fórmula reducida)";
+            cerr << " en " << segundos << " s" << endl;
           }
+        };
+      return ControlBusqueda(presupuesto, aviso, mejorExterno, costoFijo);
+    };
+    auto perfilar = [&](int metodo, ControlBusqueda &c, double segundos)
+    {
+      c.avisarPendiente();
+      c.acumular(ws.ev.getContadores() - antes);
+      perfiles[r][metodo] = {c.getContadores(), segundos, c.getSegundosMejor()};
+    };
+
+    // 1. HEURISTICA CONSTRUCTIVA (Base), o completar el arranque en caliente
+    vector<TBool> vars = inicioBusqueda;
+
+    auto start = chrono::high_resolution_clock::now();
+    problema.solverConstructivo(vars, frecuenciasBase, ws); // Construimos solucion inicial
+    auto end = chrono::high_resolution_clock::now();
+
+    double costoH = costoOriginal(vars);
+    tH[r] = chrono::duration<double>(end - start).count();
+    cH[r] = costoH;
+
+    // Copiamos la solucion de la heuristica para usarla en LS y en ILS por separado
+    vector<TBool> varsParaLS = vars;
+    vector<TBool> varsParaILS = vars;
+    vector<TBool> varsParaTS = vars;
+    vector<TBool> varsParaSA = vars;
+    vector<TBool> varsParaSLS = vars;
+    // Usamos una copia limpia de las variables (GRASP construye su propia solución)
+    vector<TBool> varsParaGRASP(numVariables, TBool::Unknown);
+
+    // 2. BUSQUEDA LOCAL
+    start = chrono::high_resolution_clock::now();
+    ControlBusqueda controlLS = control("LS");
+    problema.busquedaLocal(varsParaLS, ws, controlLS);
+    end = chrono::high_resolution_clock::now();
+
+    tLS[r] = chrono::duration<double>(end - start).count();
+    perfilar(0, controlLS, tLS[r]);
+    cLS[r] = costoOriginal(varsParaLS);
+
+    // 3. BUSQUEDA LOCAL ITERADA
+    start = chrono::high_resolution_clock::now();
+    ControlBusqueda controlILS = control("ILS");
+    problema.busquedaLocalIterada(varsParaILS, iteraciones(20), genILS, ws, controlILS);
+    end = chrono::high_resolution_clock::now();
+
+    tILS[r] = chrono::duration<double>(end - start).count();
+    perfilar(1, controlILS, tILS[r]);
+    cILS[r] = costoOriginal(varsParaILS);
+
+    // 4. BUSQUEDA TABU
+    start = chrono::high_resolution_clock::now();
+    int tenure = 7 + (numVariables / 10); // Ejemplo de tenure proporcional
+    ControlBusqueda controlTS = control("TS");
+    if (opciones.hilosTabu > 1)
+      problema.busquedaTabuCooperativa(varsParaTS, iteraciones(100), tenure, opciones.hilosTabu, 10, genTS, controlTS);
+    else
+      problema.busquedaTabu(varsParaTS, iteraciones(100), tenure, genTS, ws, controlTS);
+    end = chrono::high_resolution_clock::now();
+
+    tTS[r] = chrono::duration<double>(end - start).count();
+    perfilar(2, controlTS, tTS[r]);
+    cTS[r] = costoOriginal(varsParaTS);
+
+    // 5. RECOCIDO SIMULADO
+    start = chrono::high_resolution_clock::now();
+    // Parámetros sugeridos: temp inicial 10, enfriamiento 0.98, 100 iter por nivel
+    ControlBusqueda controlSA = control("SA");
+    problema.recocidoSimulado(varsParaSA, genSA, ws, opciones.sa, controlSA);
+    end = chrono::high_resolution_clock::now();
+
+    tSA[r] = chrono::duration<double>(end - start).count();
+    perfilar(3, controlSA, tSA[r]);
+    cSA[r] = costoOriginal(varsParaSA);
+
+    // 6. GRASP
+    start = chrono::high_resolution_clock::now();
+    // Parámetros: 20 iteraciones, alpha = 0.2 (20% de aleatoriedad en RCL)
+    ControlBusqueda controlGRASP = control("GRASP");
+    problema.busquedaGRASP(varsParaGRASP, 20, 0.2, genGRASP, frecuenciasBase, controlGRASP);
+    end = chrono::high_resolution_clock::now();
+
+    tGRASP[r] = chrono::duration<double>(end - start).count();
+    perfilar(4, controlGRASP, tGRASP[r]);
+    cGRASP[r] = costoOriginal(varsParaGRASP);
+
+    // 7. BUSQUEDA LOCAL FOCALIZADA (WalkSAT / ProbSAT)
+    start = chrono::high_resolution_clock::now();
+    ControlBusqueda controlSLS = control("SLS");
+    problema.busquedaFocalizada(varsParaSLS, flipsColumnaSLS, opciones.sls, genSLS, ws, controlSLS);
+    end = chrono::high_resolution_clock::now();
+
+    tSLS[r] = chrono::duration<double>(end - start).count();
+    perfilar(5, controlSLS, tSLS[r]);
+    cSLS[r] = costoOriginal(varsParaSLS);
+
+    if (!opciones.rutaSoluciones.empty())
+    {
+      const vector<TBool> *finales[NUM_COLUMNAS_REPORTE] = {&vars, &varsParaLS, &varsParaILS, &varsParaTS, &varsParaSA,
+                                                            &varsParaGRASP, &varsParaSLS};
+      const double costosCorrida[NUM_COLUMNAS_REPORTE] = {cH[r], cLS[r], cILS[r], cTS[r], cSA[r], cGRASP[r], cSLS[r]};
+      lock_guard<mutex> lock(mtxSolucion);
+      for (int k = 0; k < NUM_COLUMNAS_REPORTE; k++)
+        if (costosCorrida[k] < costoSolucion ||
+            (costosCorrida[k] == costoSolucion && make_pair(iter, k) < origenSolucion))
+        {
+          costoSolucion = costosCorrida[k];
+          origenSolucion = {iter, k};
+          mejorSolucion = *finales[k];
+        }
+    }
+
+    if (salida)
+    {
+      salida->escribir({nombreArchivo, iter, "H", semilla, (Peso)cH[r], tH[r], 0});
+      const double costos[NUM_METODOS_PERFIL] = {cLS[r], cILS[r], cTS[r], cSA[r], cGRASP[r], cSLS[r]};
+      for (int k = 0; k < NUM_METODOS_PERFIL; k++)
+        salida->escribir({nombreArchivo, iter, METODOS_PERFIL[k], semilla, (Peso)costos[k], perfiles[r][k].segundos,
+                          perfiles[r][k].contadores.flips});
+    }
+
+  }
+
+  // Medias para las líneas de Exacto y --perfil (la fila las calcula en imprimirFila)
+  double mCH = promedio(cH);
+  double mTH = promedio(tH);
+  double mCLS = promedio(cLS);
+  double mCILS = promedio(cILS);
+  double mCTS = promedio(cTS);
+  double mCSA = promedio(cSA);
+  double mCGRASP = promedio(cGRASP);
+  double mCSLS = promedio(cSLS);
+
+  // Columna Exacto: óptimo o cota inferior, con el mejor costo de las corridas como cota superior
+  ResultadoExacto exacto;
+  string textoExacto;
+  if (opciones.segundosExacto > 0)
+  {
+    Peso mejorCorridas = numeric_limits<Peso>::max();
+    for (const vector<double> *costos : {&cH, &cLS, &cILS, &cTS, &cSA, &cGRASP, &cSLS})
+      for (double c : *costos)
+        mejorCorridas = min(mejorCorridas, (Peso)c);
+    string nombreCache = nombreArchivo + ".exacto";
+    if (opciones.usarCache && leerCacheExacto(nombreCache, carga.hashFuente, carga.bytes, opciones.segundosExacto, exacto))
+      exacto.costo = min(exacto.costo, mejorCorridas);
+    else
+    {
+      Presupuesto limite;
+      limite.segundos = opciones.segundosExacto;
+      ControlBusqueda controlExacto(limite);
+      exacto = SolverExacto(formulaBase).resolver(mejorCorridas, controlExacto);
+      if (opciones.usarCache)
+        escribirCacheExacto(nombreCache, carga.hashFuente, carga.bytes, opciones.segundosExacto, exacto);
+    }
+    textoExacto = exacto.demostrado ? to_string(exacto.costo) : ">=" + to_string(exacto.cotaInferior);
+  }
+
+  if (!opciones.rutaSoluciones.empty() && !mejorSolucion.empty())
+  {
+    Peso costo = costoSolucion;
+    bool optimo = costo == 0 || (opciones.segundosExacto > 0 && exacto.demostrado && exacto.costo == costo);
+    string ruta = opciones.rutaSoluciones + "/" + nombreSolucion;
+    // Con --nodo el archivo solo ve las corridas de este nodo
+    string corridasVistas = opciones.numNodos > 1 ? to_string(numCorridas) + " de " + to_string(NUM_CORRIDAS) +
+                                                        " corridas, nodo " + to_string(opciones.nodo) + "/" +
+                                                        to_string(opciones.numNodos)
+                                                  : to_string(numCorridas) + " corridas";
+    string comentario = nombreArchivo + ": mejor de " + corridasVistas + " (" + COLUMNAS_REPORTE[origenSolucion.second] +
+                        ", corrida " + to_string(origenSolucion.first) + ")";
+    if (!escribirSolucion(ruta, comentario, costo, optimo, aEntrada(mejorSolucion)))
+    {
+#pragma omp critical
+      cerr << "Aviso: no se pudo escribir " << ruta << endl;
+    }
+  }
+
+#pragma omp critical
+  {
+    const vector<double> *costos[NUM_COLUMNAS_REPORTE] = {&cH, &cLS, &cILS, &cTS, &cSA, &cGRASP, &cSLS};
+    const vector<double> *tiempos[NUM_COLUMNAS_REPORTE] = {&tH, &tLS, &tILS, &tTS, &tSA, &tGRASP, &tSLS};
+    imprimirFila(nombreArchivo, textoExacto, costos, tiempos);
+
+    if (opciones.segundosExacto > 0)
+    {
+      // Brecha real: costo medio de cada método menos el óptimo (o la cota)
+      cout << "  Exacto: " << (exacto.demostrado ? "óptimo " : "cota inferior ") << exacto.cotaInferior << " en "
+           << exacto.segundos << " s; exceso medio H " << mCH - exacto.cotaInferior;
+      const double medias[NUM_METODOS_PERFIL] = {mCLS, mCILS, mCTS, mCSA, mCGRASP, mCSLS};
+      for (int k = 0; k < NUM_METODOS_PERFIL; k++)
+        cout << " " << METODOS_PERFIL[k] << " " << medias[k] - exacto.cotaInferior;
+      cout << endl;
+    }
+
+    if (opciones.perfil)
+    {
+      // Promedios por corrida; flips/s sobre el tiempo total del método
+      cout << "  Perfil: carga " << carga.segundos << " s, preprocesado " << preprocesado.getSegundos()
+           << " s, construcción " << mTH << " s" << endl;
+      for (int k = 0; k < NUM_METODOS_PERFIL; k++)
+      {
+        PerfilMetodo total;
+        for (const auto &corrida : perfiles)
+        {
+          total.contadores += corrida[k].contadores;
+          total.segundos += corrida[k].segundos;
+          total.segundosMejor += corrida[k].segundosMejor;
+        }
+        const Contadores &c = total.contadores;
+        cout << "    " << setw(6) << METODOS_PERFIL[k]
+             << " flips/s " << setw(11) << (total.segundos > 0 ? c.flips / total.segundos : 0.0)
+             << " flips " << setw(11) << c.flips / numCorridas
+             << " evaluados " << setw(11) << c.evaluados / numCorridas
+             << " recuentos " << setw(7) << c.recuentos / numCorridas
+             << " copias " << setw(7) << c.copias / numCorridas
+             << " t.mejor " << total.segundosMejor / numCorridas << " s" << endl;
       }
-      // Retornar la mejor solución encontrada en todo el proceso
-      vars = mejorSolucionGlobal;
+    }
   }
+}
+
+// Carga la instancia en la propia tarea y la resuelve (sin --precarga)
+void resolverInstancia(const string &nombreArchivo, const Opciones &opciones, SalidaRegistros *salida)
+{
+  FormulaCompacta formulaBase;
+  EstadisticasCarga carga;
+  if (cargarFormula(nombreArchivo, formulaBase, &carga, opciones.usarCache, opciones.porBloques))
+    resolverInstancia(nombreArchivo, formulaBase, carga, opciones, salida);
+}
 
-  void recocidoSimulado(vector<TBool> &vars, mt19937 &gen, double tempInicial = 10.0, double alpha = 0.95, int iterPorTemp = 100) 
+/**
+ * Etapa de carga en segundo plano. Un hilo propio parsea las instancias en el
+ * orden de la campaña y deja cada una en una cola de a lo sumo capacidad
+ * fórmulas listas; cada tarea de resolución saca la siguiente al empezar. Así
+ * la lectura y el parseo de las próximas instancias se solapan con las
+ * corridas de las actuales, y la cola acota la memoria de las que esperan.
+ */
+class CargadorInstancias
+{
+public:
+  struct Instancia
   {
-      int n = vars.size();
-      vector<TBool> actual = vars;
-      vector<TBool> mejorSolucionGlobal = vars;
-      
-      int costoActual = calcularCosto(actual);
-      int mejorCostoGlobal = costoActual;
-      
-      double T = tempInicial;
-      double T_min = 0.01; // Temperatura de parada
+    string nombre;
+    FormulaCompacta formula;
+    EstadisticasCarga carga;
+    bool valida = false;
+  };
 
-      // Distribuciones para aleatoriedad
-      uniform_int_distribution<> varDist(0, n - 1);
-      uniform_real_distribution<> probDist(0.0, 1.0);
+private:
+  vector<string> nombres; // en orden de carga
+  size_t capacidad;
+  bool usarCache, porBloques;
+  deque<unique_ptr<Instancia>> listas;
+  bool detener = false;
+  mutex mtx;
+  condition_variable hayLugar, hayLista;
+  thread cargador;
 
-      while (T > T_min) 
+  void bucleCarga()
+  {
+    for (const string &nombre : nombres)
+    {
       {
-          for (int i = 0; i < iterPorTemp; i++) 
-          {
-              // 1. Elegir un vecino aleatorio (1-flip)
-              int idx = varDist(gen);
-              actual[idx] = (actual[idx] == TBool::True) ? TBool::False : TBool::True;
-              
-              int nuevoCosto = calcularCosto(actual);
-              int delta = nuevoCosto - costoActual; // delta < 0 es una mejora
-
-              // 2. Criterio de aceptación (Metrópolis)
-              if (delta < 0) 
-              {
-                  // Mejora directa
-                  costoActual = nuevoCosto;
-                  if (costoActual < mejorCostoGlobal) 
-                  {
-                      mejorCostoGlobal = costoActual;
-                      mejorSolucionGlobal = actual;
-                  }
-              } 
-              else 
-              {
-                  // Movimiento peor: se acepta con probabilidad e^(-delta / T)
-                  double probabilidad = exp(-delta / T);
-                  if (probDist(gen) < probabilidad) 
-                  {
-                      costoActual = nuevoCosto;
-                  } 
-                  else 
-                  {
-                      // No se acepta: revertir el flip
-                      actual[idx] = (actual[idx] == TBool::True) ? TBool::False : TBool::True;
-                  }
-              }
-          }
-          // 3. Enfriamiento
-          T *= alpha;
+        unique_lock<mutex> lock(mtx);
+        hayLugar.wait(lock, [this] { return detener || listas.size() < capacidad; });
+        if (detener)
+          return;
       }
-      vars = mejorSolucionGlobal;
+      auto instancia = make_unique<Instancia>();
+      instancia->nombre = nombre;
+      instancia->valida = cargarFormula(nombre, instancia->formula, &instancia->carga, usarCache, porBloques);
+      {
+        lock_guard<mutex> lock(mtx);
+        listas.push_back(move(instancia));
+      }
+      hayLista.notify_one();
+    }
   }
 
-  /**
-   * Fase de Construcción de GRASP: Greedy Randomized
-   * @param alpha Parámetro entre 0 y 1. 
-   * 0 = Totalmente Greedy, 1 = Totalmente Aleatorio.
-   */
-  void construccionGRASP(vector<TBool> &vars, vector<Conteo> frecs, double alpha, mt19937 &gen) 
+public:
+  CargadorInstancias(vector<string> enOrden, size_t cap, bool cache, bool bloques)
+      : nombres(move(enOrden)), capacidad(max<size_t>(1, cap)), usarCache(cache), porBloques(bloques)
   {
-      int n = vars.size();
-      vector<int> asignados;
-      
-      // Trabajamos con una copia de las cláusulas para simular la construcción
-      for (int i = 0; i < n; i++) 
-      {
-          // 1. Encontrar el rango de beneficio (S_min y S_max)
-          int s_min = numeric_limits<int>::max();
-          int s_max = numeric_limits<int>::min();
-          
-          vector<pair<int, int>> candidatos; // {indice_var, beneficio}
-          for (int j = 0; j < n; j++) {
-              if (vars[j] == TBool::Unknown) {
-                  int beneficio = max(frecs[j].pos, frecs[j].neg);
-                  s_min = min(s_min, beneficio);
-                  s_max = max(s_max, beneficio);
-                  candidatos.push_back({j, beneficio});
-              }
-          }
-
-          // 2. Definir el umbral para la RCL (Lista Restringida de Candidatos)
-          // Umbral = S_max - alpha * (S_max - S_min)
-          double umbral = s_max - alpha * (s_max - s_min);
-          
-          vector<int> rcl;
-          for (auto& c : candidatos) {
-              if (c.second >= umbral) {
-                  rcl.push_back(c.first);
-              }
-          }
-
-          // 3. Selección aleatoria de la RCL
-          uniform_int_distribution<> dis(0, rcl.size() - 1);
-          int idElegido = rcl[dis(gen)];
-          
-          // Asignar y actualizar (similar a tu solverConstructivo)
-          bool valor = frecs[idElegido].pos >= frecs[idElegido].neg;
-          vars[idElegido] = valor ? TBool::True : TBool::False;
-          
-          // Marcamos como procesada
-          frecs[idElegido].pos = -99999;
-          frecs[idElegido].neg = -99999;
-      }
+    cargador = thread(&CargadorInstancias::bucleCarga, this);
   }
 
-  void busquedaGRASP(vector<TBool> &vars, int maxIteraciones, double alpha, mt19937 &gen, const vector<Conteo>& frecsOriginales) 
+  ~CargadorInstancias()
   {
-      int mejorCostoGlobal = numeric_limits<int>::max();
-      vector<TBool> mejorSolucionGlobal;
+    {
+      lock_guard<mutex> lock(mtx);
+      detener = true;
+    }
+    hayLugar.notify_one();
+    cargador.join();
+  }
 
-      for (int i = 0; i < maxIteraciones; i++) 
-      {
-          vector<TBool> actual(vars.size(), TBool::Unknown);
-          // Enviamos copia de las frecuencias ya que la fase constructiva las modifica
-          construccionGRASP(actual, frecsOriginales, alpha, gen); 
-          busquedaLocal(actual);
-          
-          int costoFinal = calcularCosto(actual);
-          if (costoFinal < mejorCostoGlobal) {
-              mejorCostoGlobal = costoFinal;
-              mejorSolucionGlobal = actual;
-          }
-      }
-      vars = mejorSolucionGlobal;
+  // Espera a que la siguiente instancia de la campaña esté cargada; llamar una vez por instancia
+  unique_ptr<Instancia> sacar()
+  {
+    unique_lock<mutex> lock(mtx);
+    hayLista.wait(lock, [this] { return !listas.empty(); });
+    unique_ptr<Instancia> instancia = move(listas.front());
+    listas.pop_front();
+    lock.unlock();
+    hayLugar.notify_one();
+    return instancia;
   }
 };
 
-Clausula crearClausula(string linea, vector<Conteo> &frecuencias)
+/**
+ * Modo --bench: mediciones de una sola hebra, con semilla y presupuesto fijos,
+ * para comparar compilaciones. Por instancia mide el ritmo del parser, del
+ * recuento completo, de flip y delta, de ambas construcciones, y el costo de
+ * cada método con un presupuesto de flips fijo. Los resultados se guardan en un
+ * archivo de línea base (instancia, métrica, valor por línea) y se comparan
+ * con uno anterior: un ritmo que cae más de la tolerancia, o un costo que
+ * sube, cuenta como regresión.
+ */
+struct MetricaBench
+{
+  string instancia;
+  string nombre;
+  double valor;
+  bool mayorEsMejor; // ritmos por segundo; los costos son mejores cuanto menores
+};
+
+// Operaciones por segundo de op, repitiéndola al menos segundosMinimos
+template <class Op>
+double medirRitmo(Op op, double segundosMinimos = 0.1)
 {
-  stringstream ss(linea);
-  int variable = 0;
-  vector<int> variables;
-  while (ss >> variable && variable != 0)
+  long long repeticiones = 0;
+  auto start = chrono::high_resolution_clock::now();
+  double transcurrido = 0;
+  do
   {
-    if (variable > 0)
-      frecuencias[abs(variable) - 1].pos++;
-    else
-      frecuencias[abs(variable) - 1].neg++;
-    variables.push_back(variable);
+    op();
+    repeticiones++;
+    transcurrido = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+  } while (transcurrido < segundosMinimos);
+  return repeticiones / transcurrido;
+}
+
+void medirInstancia(const string &nombreArchivo, const Opciones &opciones, vector<MetricaBench> &metricas)
+{
+  FormulaCompacta formula;
+  if (!cargarFormula(nombreArchivo, formula))
+  {
+    cerr << "No se pudo abrir " << nombreArchivo << endl;
+    return;
+  }
+  size_t barra = nombreArchivo.find_last_of('/');
+  string nombreBase = barra == string::npos ? nombreArchivo : nombreArchivo.substr(barra + 1);
+  auto registrar = [&](const string &nombre, double valor, bool mayorEsMejor)
+  { metricas.push_back({nombreBase, nombre, valor, mayorEsMejor}); };
+
+  // Micro-mediciones
+  ArchivoMapeado archivo;
+  archivo.abrir(nombreArchivo);
+  registrar("parser_MBps", medirRitmo([&] { FormulaCompacta f; parsearDimacs(archivo, f); }) *
+                               archivo.getTamano() / (1024.0 * 1024.0), true);
+
+  Formula problema(formula);
+  auto espacio = problema.prestarEspacio();
+  EspacioTrabajo &ws = *espacio;
+  int n = formula.getNumVariables();
+  vector<TBool> inicial(n, TBool::Unknown);
+  registrar("constructiva_por_s", medirRitmo([&] {
+              inicial.assign(n, TBool::Unknown);
+              problema.solverConstructivo(inicial, formula.getFrecuencias(), ws);
+            }), true);
+  Generador genGRASP(1);
+  vector<TBool> construida(n);
+  registrar("grasp_por_s", medirRitmo([&] {
+              construida.assign(n, TBool::Unknown);
+              problema.construccionGRASP(construida, formula.getFrecuencias(), 0.2, genGRASP, ws);
+            }), true);
+
+  AsignacionCompacta compacta(inicial);
+  volatile Peso sumidero = 0;
+  registrar("recuentos_por_s", medirRitmo([&] { sumidero = sumidero + problema.calcularCosto(compacta); }), true);
+
+  const int LOTE = 4096;
+  vector<int> azar(LOTE);
+  Generador genAzar(2);
+  for (int &v : azar)
+    v = genAzar() % max(1, n);
+  ws.ev.inicializar(inicial);
+  if (n > 0)
+  {
+    registrar("flips_por_s", LOTE * medirRitmo([&] { for (int v : azar) ws.ev.flip(v); }), true);
+    registrar("deltas_por_s", LOTE * medirRitmo([&] {
+                Peso suma = 0;
+                for (int v : azar)
+                  suma += ws.ev.delta(v);
+                sumidero = sumidero + suma;
+              }), true);
+  }
+
+  // Calidad con semilla y presupuesto fijos (la semilla de la corrida 0 del reporte)
+  Presupuesto presupuesto;
+  presupuesto.maxFlips = 200000;
+  uint64_t semilla = derivarSemilla(hashContenido(nombreBase.data(), nombreBase.size()), 0);
+  auto generador = [semilla](int metodo) { return Generador(derivarSemilla(semilla, metodo + 1)); };
+  const int ilimitado = numeric_limits<int>::max();
+  for (int k = 0; k < NUM_METODOS_PERFIL; k++)
+  {
+    vector<TBool> vars = inicial;
+    Generador gen = generador(k);
+    ControlBusqueda control(presupuesto);
+    switch (k)
+    {
+    case 0: problema.busquedaLocal(vars, ws, control); break;
+    case 1: problema.busquedaLocalIterada(vars, ilimitado, gen, ws, control); break;
+    case 2: problema.busquedaTabu(vars, ilimitado, 7 + n / 10, gen, ws, control); break;
+    case 3: problema.recocidoSimulado(vars, gen, ws, opciones.sa, control); break;
+    case 4:
+      vars.assign(n, TBool::Unknown);
+      problema.busquedaGRASP(vars, 20, 0.2, gen, formula.getFrecuencias(), control);
+      break;
+    default: problema.busquedaFocalizada(vars, numeric_limits<long long>::max(), opciones.sls, gen, ws, control);
+    }
+    registrar(string("costo_") + METODOS_PERFIL[k], problema.calcularCosto(vars), false);
   }
-  return Clausula(variables);
 }
 
-pair<int, int> leerPreambulo(string linea)
+// Lee una línea base de --bench; false si no se puede abrir
+bool leerLineaBase(const string &ruta, vector<MetricaBench> &base)
 {
-  stringstream ss(linea);
-  string temp;
-  ss >> temp >> temp;
-  int vars, clausulas;
-  ss >> vars >> clausulas;
-  return {vars, clausulas};
+  ifstream in(ruta);
+  if (!in)
+    return false;
+  string linea;
+  while (getline(in, linea))
+  {
+    if (linea.empty() || linea[0] == '#')
+      continue;
+    istringstream campos(linea);
+    MetricaBench m{};
+    if (getline(campos, m.instancia, '\t') && getline(campos, m.nombre, '\t') && campos >> m.valor)
+      base.push_back(m);
+  }
+  return true;
 }
 
-// Funciones estadísticas
-double promedio(const vector<double> &v)
+// Ejecuta --bench; devuelve el código de salida (1 si hubo regresiones o errores)
+int ejecutarBench(const vector<string> &archivos, const Opciones &opciones)
 {
-  if (v.empty())
-    return 0.0;
-  return accumulate(v.begin(), v.end(), 0.0) / v.size();
+  vector<MetricaBench> metricas;
+  for (const string &archivo : archivos)
+  {
+    size_t antes = metricas.size();
+    medirInstancia(archivo, opciones, metricas);
+    for (size_t i = antes; i < metricas.size(); i++)
+      cout << left << setw(20) << metricas[i].instancia << setw(22) << metricas[i].nombre << metricas[i].valor << endl;
+  }
+
+  int regresiones = 0;
+  if (!opciones.rutaLineaBase.empty())
+  {
+    vector<MetricaBench> base;
+    if (!leerLineaBase(opciones.rutaLineaBase, base))
+    {
+      cerr << "No se pudo leer la línea base " << opciones.rutaLineaBase << endl;
+      return 1;
+    }
+    for (const MetricaBench &m : metricas)
+      for (const MetricaBench &b : base)
+      {
+        if (b.instancia != m.instancia || b.nombre != m.nombre)
+          continue;
+        bool regresion = m.mayorEsMejor ? m.valor < b.valor * (1 - opciones.toleranciaBench) : m.valor > b.valor;
+        if (regresion)
+        {
+          regresiones++;
+          cout << "REGRESIÓN " << m.instancia << " " << m.nombre << ": " << b.valor << " -> " << m.valor << endl;
+        }
+      }
+    cout << regresiones << " regresiones frente a " << opciones.rutaLineaBase << endl;
+  }
+
+  if (!opciones.rutaGuardarBase.empty())
+  {
+    ofstream out(opciones.rutaGuardarBase);
+    out << "# instancia\tmetrica\tvalor (--bench)" << endl;
+    out << setprecision(10);
+    for (const MetricaBench &m : metricas)
+      out << m.instancia << '\t' << m.nombre << '\t' << m.valor << '\n';
+    if (!out)
+    {
+      cerr << "No se pudo escribir " << opciones.rutaGuardarBase << endl;
+      return 1;
+    }
+  }
+  return regresiones > 0 ? 1 : 0;
 }
 
-double desviacionEstandar(const vector<double> &v, const double media)
+// Agrega arg a archivos; si es un directorio, agrega sus .cnf y .wcnf en orden alfabético
+void expandirArgumento(const string &arg, vector<string> &archivos)
 {
-  if (v.size() < 2)
-    return 0.0;
-  double sumCuadrados = accumulate(v.begin(), v.end(), 0.0,
-      [media](double acc, double val) {
-          return acc + pow(val - media, 2);
-      });
-  return sqrt(sumCuadrados / (v.size() - 1));
+  DIR *dir = opendir(arg.c_str());
+  if (!dir)
+  {
+    archivos.push_back(arg);
+    return;
+  }
+  vector<string> encontrados;
+  while (dirent *entrada = readdir(dir))
+  {
+    string nombre = entrada->d_name;
+    auto termina = [&nombre](const string &sufijo)
+    { return nombre.size() > sufijo.size() && nombre.compare(nombre.size() - sufijo.size(), sufijo.size(), sufijo) == 0; };
+    if (termina(".cnf") || termina(".wcnf"))
+      encontrados.push_back(arg + "/" + nombre);
+  }
+  closedir(dir);
+  sort(encontrados.begin(), encontrados.end());
+  archivos.insert(archivos.end(), encontrados.begin(), encontrados.end());
 }
 
-string formatearMedida(double media, double desv_est) {
-    if (desv_est <= 0) return to_string(media) + "(0)";
+// Campos de una línea de registros: CSV (con comillas dobles) o un objeto JSON plano
+bool leerRegistro(const string &linea, bool jsonl, string &instancia, int &corrida, string &algoritmo, double &costo,
+                  double &segundos)
+{
+  if (jsonl)
+  {
+    auto valor = [&linea](const string &clave) -> string
+    {
+      size_t p = linea.find("\"" + clave + "\":");
+      if (p == string::npos)
+        return "";
+      p += clave.size() + 3;
+      if (p < linea.size() && linea[p] == '"')
+      {
+        string r;
+        for (p++; p < linea.size() && linea[p] != '"'; p++)
+          r += linea[p] == '\\' && p + 1 < linea.size() ? linea[++p] : linea[p];
+        return r;
+      }
+      return linea.substr(p, linea.find_first_of(",}", p) - p);
+    };
+    instancia = valor("instancia");
+    algoritmo = valor("algoritmo");
+    string c = valor("corrida"), co = valor("costo"), se = valor("segundos");
+    if (instancia.empty() || algoritmo.empty() || c.empty() || co.empty() || se.empty())
+      return false;
+    corrida = atoi(c.c_str());
+    costo = atof(co.c_str());
+    segundos = atof(se.c_str());
+    return true;
+  }
 
-    // 1. Encontrar la posición de la primera cifra significativa de la desv. estándar
-    // Log10 nos dice la magnitud. Floor nos da el exponente entero.
-    int exponente = floor(log10(desv_est));
-    
-    // 2. Extraer esa primera cifra
-    // Multiplicamos para que la cifra sea la unidad, y redondeamos.
-    int cifra = round(desv_est / pow(10, exponente));
-    
-    // Caso especial: si el redondeo nos lleva a 10 (ej: 0.099 -> 0.1)
-    if (cifra == 10) {
-        cifra = 1;
-        exponente++;
-    }
+  vector<string> campos(1);
+  bool comillas = false;
+  for (size_t i = 0; i < linea.size(); i++)
+  {
+    char ch = linea[i];
+    if (comillas && ch == '"' && i + 1 < linea.size() && linea[i + 1] == '"')
+      campos.back() += linea[++i];
+    else if (ch == '"')
+      comillas = !comillas;
+    else if (ch == ',' && !comillas)
+      campos.emplace_back();
+    else
+      campos.back() += ch;
+  }
+  if (campos.size() != 7 || campos[0] == "instancia")
+    return false;
+  instancia = campos[0];
+  corrida = atoi(campos[1].c_str());
+  algoritmo = campos[2];
+  costo = atof(campos[4].c_str());
+  segundos = atof(campos[5].c_str());
+  return true;
+}
 
-    // 3. Formatear la media con la precisión adecuada
-    stringstream ss;
-    if (exponente < 0) {
-        // Si la cifra está en los decimales
-        ss << fixed << setprecision(abs(exponente)) << media;
-    } else {
-        // Si la cifra es mayor o igual a 1, redondeamos a la unidad/decena pertinente
-        double factor = pow(10, exponente);
-        ss << fixed << setprecision(0) << round(media / factor) * factor;
+/**
+ * --combinar: junta los registros (--registros) que dejaron los nodos de una
+ * campaña con --nodo k/N e imprime el reporte con la misma agregación media(σ)
+ * que una campaña en un solo nodo. Las instancias se agrupan por nombre sin
+ * directorio y una corrida repetida en varios archivos cuenta una sola vez. La
+ * columna Exacto queda vacía porque el solver exacto no deja registros.
+ */
+int combinarRegistros(const vector<string> &rutas)
+{
+  // instancia -> columna -> corrida -> (costo, segundos)
+  map<string, vector<map<int, pair<double, double>>>> tabla;
+  for (const string &ruta : rutas)
+  {
+    ifstream in(ruta);
+    if (!in)
+    {
+      cerr << "No se pudo leer " << ruta << endl;
+      return 1;
+    }
+    bool jsonl = (ruta.size() >= 6 && ruta.compare(ruta.size() - 6, 6, ".jsonl") == 0) ||
+                 (ruta.size() >= 5 && ruta.compare(ruta.size() - 5, 5, ".json") == 0);
+    string linea, instancia, algoritmo;
+    int corrida;
+    double costo, segundos;
+    while (getline(in, linea))
+    {
+      if (!leerRegistro(linea, jsonl, instancia, corrida, algoritmo, costo, segundos))
+        continue;
+      int k = find(COLUMNAS_REPORTE, COLUMNAS_REPORTE + NUM_COLUMNAS_REPORTE, algoritmo) - COLUMNAS_REPORTE;
+      if (k == NUM_COLUMNAS_REPORTE)
+        continue;
+      vector<map<int, pair<double, double>>> &columnas = tabla[nombreSinDirectorio(instancia)];
+      columnas.resize(NUM_COLUMNAS_REPORTE);
+      columnas[k].emplace(corrida, make_pair(costo, segundos));
     }
+  }
 
-    // 4. Construir el string final
-    return ss.str() + "(" + to_string(cifra) + ")";
+  imprimirEncabezado();
+  for (const auto &[instancia, columnas] : tabla)
+  {
+    vector<double> costos[NUM_COLUMNAS_REPORTE], tiempos[NUM_COLUMNAS_REPORTE];
+    const vector<double> *pc[NUM_COLUMNAS_REPORTE], *pt[NUM_COLUMNAS_REPORTE];
+    size_t menos = NUM_CORRIDAS;
+    for (int k = 0; k < NUM_COLUMNAS_REPORTE; k++)
+    {
+      for (const auto &[corrida, medida] : columnas[k])
+      {
+        costos[k].push_back(medida.first);
+        tiempos[k].push_back(medida.second);
+      }
+      menos = min(menos, costos[k].size());
+      pc[k] = &costos[k];
+      pt[k] = &tiempos[k];
+    }
+    if (menos < (size_t)NUM_CORRIDAS)
+      cerr << "Aviso: " << instancia << " tiene " << menos << " de " << NUM_CORRIDAS << " corridas en los registros" << endl;
+    imprimirFila(instancia, "", pc, pt);
+  }
+  cout << "==========================================================================================================" << endl;
+  return 0;
 }
 
 int main(int argc, char const *argv[])
@@ -542,195 +5122,180 @@ int main(int argc, char const *argv[])
   ios_base::sync_with_stdio(false);
   cin.tie(NULL);
 
-  if (argc < 2)
+  vector<string> archivos;
+  Opciones opciones;
+  string rutaMejores;
+  bool combinar = false;
+  for (int i = 1; i < argc; i++)
   {
-    cout << "Uso: ./solver archivo1.cnf [archivo2.cnf ...]" << endl;
-    return 1;
+    string arg = argv[i];
+    if (arg == "--cache")
+      opciones.usarCache = true;
+    else if (arg == "--por-bloques")
+      opciones.porBloques = true;
+    else if (arg == "--precarga" && i + 1 < argc)
+      opciones.precarga = max(0, atoi(argv[++i]));
+    else if (arg == "--hilos-tabu" && i + 1 < argc)
+      opciones.hilosTabu = max(1, atoi(argv[++i]));
+    else if (arg == "--sls" && i + 1 < argc)
+    {
+      string politica = argv[++i];
+      opciones.sls.politica = politica == "walksat" ? PoliticaSLS::WalkSAT
+                              : politica == "paws"  ? PoliticaSLS::PAWS
+                                                    : PoliticaSLS::ProbSAT;
+    }
+    else if (arg == "--ls-focalizada")
+      opciones.lsFocalizada = true;
+    else if (arg == "--tiempo-ms" && i + 1 < argc)
+      opciones.presupuesto.segundos = atof(argv[++i]) / 1000.0;
+    else if (arg == "--max-flips" && i + 1 < argc)
+      opciones.presupuesto.maxFlips = atoll(argv[++i]);
+    else if (arg == "--objetivo" && i + 1 < argc)
+      opciones.presupuesto.costoObjetivo = atoll(argv[++i]);
+    else if (arg == "--max-sin-mejora" && i + 1 < argc)
+      opciones.presupuesto.maxSinMejora = atoll(argv[++i]);
+    else if (arg == "--anytime")
+      opciones.trazarMejoras = true;
+    else if (arg == "--perfil")
+      opciones.perfil = true;
+    else if (arg == "--preprocesar")
+      opciones.preprocesar = true;
+    else if (arg == "--reordenar")
+      opciones.reordenar = true;
+    else if (arg == "--exacto-ms" && i + 1 < argc)
+      opciones.segundosExacto = atof(argv[++i]) / 1000.0;
+    else if (arg == "--bench")
+      opciones.bench = true;
+    else if (arg == "--linea-base" && i + 1 < argc)
+      opciones.rutaLineaBase = argv[++i];
+    else if (arg == "--guardar-base" && i + 1 < argc)
+      opciones.rutaGuardarBase = argv[++i];
+    else if (arg == "--tolerancia" && i + 1 < argc)
+      opciones.toleranciaBench = atof(argv[++i]);
+    else if (arg == "--registros" && i + 1 < argc)
+      opciones.rutaRegistros = argv[++i];
+    else if (arg == "--semilla" && i + 1 < argc)
+    {
+      opciones.repetirCorrida = true;
+      opciones.semillaCorrida = strtoull(argv[++i], nullptr, 10);
+    }
+    else if (arg == "--corrida" && i + 1 < argc)
+      opciones.corridaRepetida = min(NUM_CORRIDAS - 1, max(0, atoi(argv[++i])));
+    else if (arg == "--sa-adaptativo")
+    {
+      opciones.sa.enfriamiento = EnfriamientoSA::Adaptativo;
+      opciones.sa.nivelesSinMejora = 20;
+    }
+    else if (arg == "--nodo" && i + 1 < argc)
+    {
+      if (sscanf(argv[++i], "%d/%d", &opciones.nodo, &opciones.numNodos) != 2 || opciones.numNodos < 1 ||
+          opciones.nodo < 0 || opciones.nodo >= opciones.numNodos)
+      {
+        cerr << "--nodo espera k/N con 0 <= k < N" << endl;
+        return 1;
+      }
+    }
+    else if (arg == "--mejores" && i + 1 < argc)
+      rutaMejores = argv[++i];
+    else if (arg == "--soluciones" && i + 1 < argc)
+      opciones.rutaSoluciones = argv[++i];
+    else if (arg == "--inicio" && i + 1 < argc)
+      opciones.rutaInicio = argv[++i];
+    else if (arg == "--combinar")
+      combinar = true;
+    else if (combinar)
+      archivos.push_back(arg); // registros, no instancias
+    else
+      expandirArgumento(arg, archivos);
   }
 
-  cout << "==========================================================================================================" << endl;
-  cout << " REPORTE COMPARATIVO 30 REPETICIONES: Heurística vs Búsqueda Local (LS) vs Búsqueda Local Iterada (ILS)" << endl;
-  cout << "==========================================================================================================" << endl;
-
-  // Encabezados ajustados para 3 metodos
-  cout << left << setw(35) << "Archivo"
-       << "| " << setw(9) << "Exacto"
-       << "| " << setw(10) << "Costo H"
-       << "| " << setw(10) << "T. H(s)"
-       << "| " << setw(10) << "Costo LS"
-       << "| " << setw(10) << "T. LS(s)"
-       << "| " << setw(11) << "Costo ILS"
-       << "| " << setw(11) << "T. ILS(s)"
-       << "| " << setw(11) << "Costo TS"
-       << "| " << setw(11) << "T. TS(s)"
-       << "| " << setw(11) << "Costo SA"
-       << "| " << setw(11) << "T. SA(s)"
-       << "| " << setw(11) << "C. GRASP"
-       << "| " << setw(11) << "T. GRASP(s)"
-       << "| " << setw(6) << "Gap H-I%" << endl;
-  cout << "----------------------------------------------------------------------------------------------------------" << endl;
+  if (combinar)
+    return combinarRegistros(archivos);
 
-#pragma omp parallel for schedule(dynamic)
-  for (int f = 1; f < argc; f++)
+  if (opciones.bench)
   {
-    string nombreArchivo = argv[f];
+    // Sin instancias se miden los conjuntos incluidos en el repositorio
+    if (archivos.empty())
+      for (const char *dir : {"Corte_1/UF175.753.100", "Corte_1/Causal-Discovery"})
+        expandirArgumento(dir, archivos);
+    return ejecutarBench(archivos, opciones);
+  }
 
-    // Semilla unica por hilo
-    size_t seed = hash<string>{}(nombreArchivo) + omp_get_thread_num();
-    mt19937 gen(seed);
+  if (archivos.empty())
+  {
+    cout << "Uso: ./solver [--cache] [--por-bloques] [--precarga N] [--hilos-tabu N] [--sls walksat|probsat|paws] [--ls-focalizada] [--sa-adaptativo]"
+         << " [--tiempo-ms T] [--max-flips N] [--objetivo C] [--max-sin-mejora N] [--anytime] [--perfil] [--preprocesar] [--reordenar] [--exacto-ms T]"
+         << " [--registros salida.csv|salida.jsonl] [--semilla S] [--corrida i] [--nodo k/N] [--mejores mejores.txt]"
+         << " [--soluciones dir] [--inicio dir|solucion.sol]"
+         << " archivo1.cnf|directorio [archivo2.cnf ...]" << endl;
+    cout << "       ./solver --combinar registros1.csv [registros2.jsonl ...]" << endl;
+    cout << "       ./solver --bench [--linea-base base.tsv] [--guardar-base base.tsv] [--tolerancia 0.1]"
+         << " [archivos o directorios]" << endl;
+    return 1;
+  }
 
-    ifstream archivo(nombreArchivo);
-    if (!archivo.is_open())
-      continue;
+  imprimirEncabezado();
 
-    string linea;
-    pair<int, int> datosFormula = {0, 0};
-    vector<Clausula> clausulasBase;
-    vector<Conteo> frecuenciasBase;
+  // Con --nodo k/N (N > NUM_CORRIDAS) a algunas instancias no les toca ninguna corrida aquí
+  archivos.erase(remove_if(archivos.begin(), archivos.end(),
+                           [&opciones](const string &a) { return corridasDelNodo(a, opciones).empty(); }),
+                 archivos.end());
+  unique_ptr<MejoresCompartidos> mejores;
+  if (!rutaMejores.empty())
+  {
+    mejores = make_unique<MejoresCompartidos>(rutaMejores);
+    opciones.mejores = mejores.get();
+  }
 
-    while (getline(archivo, linea))
+  // Cada archivo es una tarea y cada una reparte sus corridas como subtareas,
+  // así una instancia grande no deja núcleos ociosos al final de la campaña.
+  // Las tareas se crean de la instancia más grande a la más chica: las grandes
+  // empiezan primero y las chicas rellenan los huecos al final.
+  vector<EstimacionInstancia> estimaciones(archivos.size());
+  for (size_t f = 0; f < archivos.size(); f++)
+    estimaciones[f] = estimarInstancia(archivos[f]);
+  vector<size_t> orden(archivos.size());
+  iota(orden.begin(), orden.end(), 0);
+  stable_sort(orden.begin(), orden.end(), [&](size_t a, size_t b) { return estimaciones[a] > estimaciones[b]; });
+  unique_ptr<SalidaRegistros> salida;
+  if (!opciones.rutaRegistros.empty())
+  {
+    salida = make_unique<SalidaRegistros>(opciones.rutaRegistros, omp_get_max_threads());
+    if (!salida->valida())
     {
-      if (linea.empty() || linea[0] == 'c')
-        continue;
-      if (linea[0] == 'p')
-      {
-        datosFormula = leerPreambulo(linea);
-        frecuenciasBase.resize(datosFormula.first);
-        clausulasBase.reserve(datosFormula.second);
-      }
-      else if (isdigit(linea[0]) || linea[0] == '-')
-      {
-        clausulasBase.push_back(crearClausula(linea, frecuenciasBase));
-      }
+      cerr << "No se pudo abrir " << opciones.rutaRegistros << endl;
+      return 1;
     }
-    archivo.close();
-
-    // Vectores para guardar promedios de los metodos
-    vector<double> tH, tLS, tILS, tTS, tSA, tGRASP;
-    vector<double> cH, cLS, cILS, cTS, cSA, cGRASP;
+  }
 
-    for (int iter = 0; iter < NUM_CORRIDAS; iter++)
-    {
-      // 1. HEURISTICA CONSTRUCTIVA (Base)
-      vector<TBool> vars = vector<TBool>(datosFormula.first, TBool::Unknown);
-      vector<Conteo> frecs = frecuenciasBase;
-      Formula problema(clausulasBase);
-
-      auto start = chrono::high_resolution_clock::now();
-      problema.solverConstructivo(vars, frecs); // Construimos solucion inicial
-      auto end = chrono::high_resolution_clock::now();
-
-      double costoH = problema.calcularCosto(vars);
-      tH.push_back(chrono::duration<double>(end - start).count());
-      cH.push_back(costoH);
-
-      // Copiamos la solucion de la heuristica para usarla en LS y en ILS por separado
-      vector<TBool> varsParaLS = vars;
-      vector<TBool> varsParaILS = vars;
-      vector<TBool> varsParaTS = vars;
-      vector<TBool> varsParaSA = vars;
-      // Usamos una copia limpia de las variables (GRASP construye su propia solución)
-      vector<TBool> varsParaGRASP(datosFormula.first, TBool::Unknown);
-
-      // 2. BUSQUEDA LOCAL
-      start = chrono::high_resolution_clock::now();
-      problema.busquedaLocal(varsParaLS);
-      end = chrono::high_resolution_clock::now();
-
-      tLS.push_back(chrono::duration<double>(end - start).count());
-      cLS.push_back(problema.calcularCosto(varsParaLS));
-
-      // 3. BUSQUEDA LOCAL ITERADA
-      start = chrono::high_resolution_clock::now();
-      problema.busquedaLocalIterada(varsParaILS, 20, gen);
-      end = chrono::high_resolution_clock::now();
-
-      tILS.push_back(chrono::duration<double>(end - start).count());
-      cILS.push_back(problema.calcularCosto(varsParaILS));
-
-      // 4. BUSQUEDA TABU
-      start = chrono::high_resolution_clock::now();
-      int tenure = 7 + (datosFormula.first / 10); // Ejemplo de tenure proporcional
-      problema.busquedaTabu(varsParaTS, 100, tenure); 
-      end = chrono::high_resolution_clock::now();
-
-      tTS.push_back(chrono::duration<double>(end - start).count());
-      cTS.push_back(problema.calcularCosto(varsParaTS));
-
-      // 5. RECOCIDO SIMULADO
-      start = chrono::high_resolution_clock::now();
-      // Parámetros sugeridos: temp inicial 10, enfriamiento 0.98, 100 iter por nivel
-      problema.recocidoSimulado(varsParaSA, gen, 10.0, 0.98, 100);
-      end = chrono::high_resolution_clock::now();
-
-      tSA.push_back(chrono::duration<double>(end - start).count());
-      cSA.push_back(problema.calcularCosto(varsParaSA));
-
-      // 6. GRASP
-      start = chrono::high_resolution_clock::now();
-      // Parámetros: 20 iteraciones, alpha = 0.2 (20% de aleatoriedad en RCL)
-      problema.busquedaGRASP(varsParaGRASP, 20, 0.2, gen, frecuenciasBase);
-      end = chrono::high_resolution_clock::now();
-
-      tGRASP.push_back(chrono::duration<double>(end - start).count());
-      cGRASP.push_back(problema.calcularCosto(varsParaGRASP));
-
-    }
-
-    // Promedios
-    double mCH = promedio(cH);
-    double mTH = promedio(tH);
-    double mCLS = promedio(cLS);
-    double mTLS = promedio(tLS);
-    double mCILS = promedio(cILS);
-    double mTILS = promedio(tILS);
-    double mCTS = promedio(cTS);
-    double mTTS = promedio(tTS);
-    double mCSA = promedio(cSA);
-    double mTSA = promedio(tSA);
-    double mCGRASP = promedio(cGRASP);
-    double mTGRASP = promedio(tGRASP);
-
-    // DesviacionesEstandar
-    double sdCH = desviacionEstandar(cH, mCH);
-    double sdTH = desviacionEstandar(tH, mTH);
-    double sdCLS = desviacionEstandar(cLS, mCLS);
-    double sdTLS = desviacionEstandar(tLS, mTLS);
-    double sdCILS = desviacionEstandar(cILS, mCILS);
-    double sdTILS = desviacionEstandar(tILS, mTILS);
-    double sdCTS = desviacionEstandar(cTS, mCTS);
-    double sdTTS = desviacionEstandar(tTS, mTTS);
-    double sdCSA = desviacionEstandar(cSA, mCSA);
-    double sdTSA = desviacionEstandar(tSA, mTSA);
-    double sdCGRASP = desviacionEstandar(cGRASP, mCGRASP);
-    double sdTGRASP = desviacionEstandar(tGRASP, mTGRASP);
-
-    // Mejora total (Heuristica vs ILS)
-    double mejora = (mCH > 0) ? ((mCH - mCILS) / mCH) * 100.0 : 0.0;
+  // Con --precarga las tareas no cargan: sacan la siguiente instancia ya parseada
+  unique_ptr<CargadorInstancias> cargador;
+  if (opciones.precarga > 0)
+  {
+    vector<string> enOrden;
+    for (size_t f : orden)
+      enOrden.push_back(archivos[f]);
+    cargador = make_unique<CargadorInstancias>(move(enOrden), opciones.precarga, opciones.usarCache, opciones.porBloques);
+  }
 
-#pragma omp critical
+#pragma omp parallel
+#pragma omp single
+  for (size_t f = 0; f < archivos.size(); f++)
+  {
+#pragma omp task firstprivate(f) shared(archivos, orden, salida, cargador)
+    if (cargador)
     {
-      // cout << fixed << setprecision(2);
-      string nombreCorto = (nombreArchivo.length() > 33) ? "..." + nombreArchivo.substr(nombreArchivo.length() - 30) : nombreArchivo;
-
-      cout << left << setw(35) << nombreCorto
-           << "| " << setw(9)
-           << "| " << setw(10) << formatearMedida(mCH, sdCH)
-           << "| " << setw(10) << formatearMedida(mTH, sdTH)
-           << "| " << setw(10) << formatearMedida(mCLS, sdCLS)
-           << "| " << setw(10) << formatearMedida(mTLS, sdTLS)
-           << "| " << setw(11) << formatearMedida(mCILS, sdCILS)
-           << "| " << setw(11) << formatearMedida(mTILS, sdTILS)
-           << "| " << setw(11) << formatearMedida(mCTS, sdCTS)
-           << "| " << setw(11) << formatearMedida(mTTS, sdTTS)
-           << "| " << setw(11) << formatearMedida(mCSA, sdCSA)
-           << "| " << setw(11) << formatearMedida(mTSA, sdTSA)
-           << "| " << setw(11) << formatearMedida(mCGRASP, sdCGRASP)
-           << "| " << setw(11) << formatearMedida(mTGRASP, sdTGRASP)
-           << "| " << setw(5) << mejora << "%" << endl;
+      unique_ptr<CargadorInstancias::Instancia> instancia = cargador->sacar();
+      if (instancia->valida)
+        resolverInstancia(instancia->nombre, instancia->formula, instancia->carga, opciones, salida.get());
     }
+    else
+      resolverInstancia(archivos[orden[f]], opciones, salida.get());
   }
+  if (salida)
+    salida->cerrar();
 
   cout << "==========================================================================================================" << endl;
+  cerr << "Pico de memoria: " << fixed << setprecision(1) << picoMemoriaMB() << " MB" << defaultfloat << endl;
   return 0;
 }
\ No newline at end of file